@@ -0,0 +1,148 @@
+/**
+ * @file arena.hpp
+ * @brief bump allocator for the per-simulation records of SYSC4001 A3 P1
+ *
+ */
+
+#ifndef ARENA_HPP_
+#define ARENA_HPP_
+
+#include<vector>
+#include<algorithm>
+#include<memory>
+#include<new>
+#include<cstddef>
+#include<cstdint>
+#include<type_traits>
+
+//What an arena has handed out since its last reset, and what it took from the system
+struct arena_stats {
+    unsigned long long  allocations = 0;        // records carved out since the last reset
+    unsigned long long  bytes = 0;              // bytes carved out since the last reset
+    unsigned long long  chunks = 0;             // chunks held, kept across resets for reuse
+    unsigned long long  chunk_allocations = 0;  // chunks ever allocated, i.e. mallocs
+};
+
+//Memory for many small records that all die together. Records are carved out of
+//large chunks one after the other and are never freed one by one: reset() drops
+//all of them at once and keeps the chunks, so the next simulation reuses them
+//without calling malloc. Only trivially destructible types can live in an arena.
+class arena {
+public:
+    explicit arena(size_t chunk_size = 64 * 1024) : chunk_size(chunk_size) {}
+
+    arena(const arena &) = delete;
+    arena &operator=(const arena &) = delete;
+
+    //Returns uninitialised memory for bytes bytes; alignment must be a power of two
+    //no larger than alignof(std::max_align_t)
+    void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if(current == chunks.size() || offset + bytes > chunks[current].size) {
+            next_chunk(bytes);
+            offset = 0;
+        }
+        used = offset + bytes;
+        usage.allocations++;
+        usage.bytes += bytes;
+        return chunks[current].memory.get() + offset;
+    }
+
+    //Forgets every record at once; the chunks stay for the next run
+    void reset() {
+        current = 0;
+        used = 0;
+        usage.allocations = 0;
+        usage.bytes = 0;
+    }
+
+    const arena_stats &stats() const { return usage; }
+
+private:
+    struct chunk {
+        std::unique_ptr<char[]> memory;     // operator new[] aligns it for any fundamental type
+        size_t                  size;
+    };
+
+    //Moves on to the next chunk that can hold bytes, allocating one if there is none.
+    //Chunks skipped because they are too small wait for the next reset.
+    void next_chunk(size_t bytes) {
+        size_t next = current == chunks.size() ? current : current + 1;
+        while(next < chunks.size() && chunks[next].size < bytes) {
+            next++;
+        }
+        if(next == chunks.size()) {
+            size_t size = std::max(chunk_size, bytes);
+            chunks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+            usage.chunks++;
+            usage.chunk_allocations++;
+        }
+        current = next;
+    }
+
+    size_t              chunk_size;
+    std::vector<chunk>  chunks;
+    size_t              current = 0;    // chunk records are carved from; chunks.size() before the first
+    size_t              used = 0;       // bytes used in it
+    arena_stats         usage;
+};
+
+//Append-only list of plain values kept in an arena, for histories that grow one
+//entry at a time (like a process's I/O start times). Values sit in blocks that
+//double in size up to 64 entries, so a short history stays small and a long one
+//costs a new block only every 64 entries.
+template<typename T>
+class arena_list {
+public:
+    void push_back(arena &storage, const T &value) {
+        if(last == nullptr || last->count == last->capacity) {
+            uint32_t capacity = last == nullptr ? 4 : std::min<uint32_t>(2 * last->capacity, 64);
+            void *memory = storage.allocate(sizeof(block) + capacity * sizeof(T), alignof(block));
+            block *added = new (memory) block{nullptr, 0, capacity};
+            (last == nullptr ? first : last->next) = added;
+            last = added;
+        }
+        last->values()[last->count++] = value;
+        count++;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    //Calls visit(value) for every value, oldest first
+    template<typename Visit>
+    void for_each(Visit visit) const {
+        for(const block *current = first; current != nullptr; current = current->next) {
+            for(uint32_t i = 0; i < current->count; i++) {
+                visit(current->values()[i]);
+            }
+        }
+    }
+
+    std::vector<T> to_vector() const {
+        std::vector<T> values;
+        values.reserve(count);
+        for_each([&values](const T &value) { values.push_back(value); });
+        return values;
+    }
+
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "arena lists hold plain values");
+    static_assert(alignof(T) <= alignof(void *), "values follow the block header directly");
+
+    //Header of one block; its values follow it in the arena
+    struct block {
+        block      *next;
+        uint32_t    count;
+        uint32_t    capacity;
+
+        T *values() { return reinterpret_cast<T *>(this + 1); }
+        const T *values() const { return reinterpret_cast<const T *>(this + 1); }
+    };
+
+    block  *first = nullptr;
+    block  *last = nullptr;
+    size_t  count = 0;
+};
+
+#endif
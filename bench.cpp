@@ -0,0 +1,281 @@
+/**
+ * @file bench.cpp
+ * Benchmark for SYSC4001 A3 P1: runs every scheduling policy over generated
+ * workloads of growing size and prints one CSV row per run, so changes to the
+ * simulation loop can be compared for speed and memory use
+ */
+
+#include "workload_generator.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// ------------------ allocation counting ------------------
+// Every operator new in the program goes through here, so a run's allocations are
+// the difference between the counters before and after it.
+
+// (GCC mistakes the replaced operators below for a new/free mismatch)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<unsigned long long> allocation_count{0};
+static std::atomic<unsigned long long> allocation_bytes{0};
+
+void *operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *block = std::malloc(size ? size : 1)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *block) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete[](void *block, std::size_t) noexcept {
+    std::free(block);
+}
+
+// over-aligned types (the process table's cache-line slots) come through these
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    void *block = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    void *block = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+#endif
+    if (block) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *block, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+void operator delete[](void *block, std::align_val_t alignment) noexcept {
+    operator delete(block, alignment);
+}
+
+void operator delete(void *block, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(block, alignment);
+}
+
+void operator delete[](void *block, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(block, alignment);
+}
+
+// ------------------ peak memory ------------------
+
+// Starts a new peak RSS measurement. Only Linux can reset the high-water mark;
+// elsewhere the peak is the highest seen by the process so far.
+static void reset_peak_rss() {
+#ifdef __linux__
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+#endif
+}
+
+// Peak resident set size in KiB, or 0 where it can't be measured
+static long peak_rss_kb() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+#endif
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;  // bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
+
+// ------------------ benchmark ------------------
+
+struct bench_result {
+    unsigned long long  events = 0;
+    double              seconds = 0;
+    long                peak_rss = 0;
+    unsigned long long  allocations = 0;
+    unsigned long long  bytes = 0;
+    arena_stats         histories;      // the run's share of the history arena
+};
+
+// Times one simulation. The workload is copied into the run like in main, so the
+// copy counts towards the allocations but the generation doesn't. The history arena
+// is reset and reused like in a sweep, so after the first run it rarely mallocs.
+static bench_result run_once(const std::string &policy_name, const std::vector<PCB> &workload,
+                             const simulation_config &config, const std::shared_ptr<arena> &storage) {
+    std::unique_ptr<scheduler_policy> policy = make_scheduler(policy_name);
+    execution_log log(LOG_DISCARD);
+    bench_result result;
+
+    reset_peak_rss();
+    unsigned long long count_before = allocation_count.load();
+    unsigned long long bytes_before = allocation_bytes.load();
+    unsigned long long chunks_before = storage->stats().chunk_allocations;
+    storage->reset();
+    auto start = std::chrono::steady_clock::now();
+
+    simulation_result simulation = run_simulation(*policy, workload, log, config, storage);
+
+    auto stop = std::chrono::steady_clock::now();
+    result.allocations = allocation_count.load() - count_before;
+    result.bytes = allocation_bytes.load() - bytes_before;
+    result.peak_rss = peak_rss_kb();
+    result.events = simulation.events;
+    result.histories = storage->stats();
+    result.histories.chunk_allocations -= chunks_before;
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    return result;
+}
+
+static void usage() {
+    std::cout << "To run the program, do: ./bin/bench [options]\n"
+              << "  --max <n>                largest workload; sizes go 10, 100, ... up to n (default 1000000)\n"
+              << "  --policies <a,b,...>     policies to run (default all: EP,RR,EP_RR,MLFQ,SJF,SRTF)\n"
+              << "  --repeat <n>             runs per case, the fastest is reported (default 3)\n"
+              << "  --seed <n>               workload seed (default 1)\n"
+              << "  --arrival <spec>         arrival process (default poisson:50)\n"
+              << "  --cpu <dist>             CPU time per process (default exp:20)\n"
+              << "  --io-freq <dist>         CPU ms between I/Os (default uniform:0:20)\n"
+              << "  --io-duration <dist>     length of each I/O (default uniform:1:10)\n"
+              << "  --allocator <mode>       fixed, first-fit, best-fit, worst-fit or buddy (default fixed)\n"
+              << "  --output <file>          write the CSV here instead of standard output\n"
+              << "  specs are the ones generate_workload takes" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    long long max_processes = 1000000;
+    std::vector<std::string> policies = scheduler_names;
+    int repeat = 3;
+    std::string output_path;
+    simulation_config config;
+
+    // keep the system below saturation by default, so the runs measure the
+    // engine rather than an ever-growing admission queue
+    workload_spec spec;
+    parse_arrivals("poisson:50", spec.arrivals);
+    parse_distribution("exp:20", spec.cpu);
+    parse_distribution("uniform:0:20", spec.io_freq);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+        std::string value = argv[++i];
+
+        bool ok = true;
+        try {
+            if (arg == "--max")              max_processes = std::stoll(value);
+            else if (arg == "--policies")    policies = split_delim(value, ",");
+            else if (arg == "--repeat")      ok = (repeat = std::stoi(value)) > 0;
+            else if (arg == "--seed")        spec.seed = std::stoull(value);
+            else if (arg == "--arrival")     ok = parse_arrivals(value, spec.arrivals);
+            else if (arg == "--cpu")         ok = parse_distribution(value, spec.cpu);
+            else if (arg == "--io-freq")     ok = parse_distribution(value, spec.io_freq);
+            else if (arg == "--io-duration") ok = parse_distribution(value, spec.io_duration);
+            else if (arg == "--allocator")   ok = parse_memory_mode(value, config.memory_allocator);
+            else if (arg == "--output")      output_path = value;
+            else                             ok = false;
+        } catch (const std::exception &) {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: bad value for " << arg << ": " << value << std::endl;
+            usage();
+            return -1;
+        }
+    }
+
+    for (const std::string &policy : policies) {
+        if (!make_scheduler(policy)) {
+            std::cerr << "Error: unknown policy: " << policy << std::endl;
+            return -1;
+        }
+    }
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file.is_open()) {
+            std::cerr << "Error: Unable to open file: " << output_path << std::endl;
+            return -1;
+        }
+    }
+    std::ostream &out = output_path.empty() ? std::cout : output_file;
+
+    out << "policy,processes,events,wall_seconds,events_per_second,peak_rss_kb,allocations,allocated_bytes,"
+        << "history_records,history_bytes,history_chunk_allocations" << std::endl;
+    std::shared_ptr<arena> storage = std::make_shared<arena>();
+
+    for (long long processes = 10; processes <= max_processes; processes *= 10) {
+        spec.processes = processes;
+        std::vector<PCB> workload = generate_workload(spec);
+
+        for (const std::string &policy : policies) {
+            bench_result best;
+            for (int run = 0; run < repeat; run++) {
+                bench_result result = run_once(policy, workload, config, storage);
+                if (run == 0 || result.seconds < best.seconds) {
+                    best = result;
+                }
+            }
+
+            out << policy << "," << processes << "," << best.events << "," << best.seconds << ","
+                << (best.seconds > 0 ? best.events / best.seconds : 0) << "," << best.peak_rss << ","
+                << best.allocations << "," << best.bytes << "," << best.histories.allocations << ","
+                << best.histories.bytes << "," << best.histories.chunk_allocations << std::endl;
+        }
+    }
+
+    return 0;
+}
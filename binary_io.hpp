@@ -0,0 +1,67 @@
+/**
+ * @file binary_io.hpp
+ * @brief little helpers for the simulator's binary files (checkpoints)
+ *
+ */
+
+#ifndef BINARY_IO_HPP_
+#define BINARY_IO_HPP_
+
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include<type_traits>
+
+//Values are written in host byte order, so a file is read back on the kind of
+//machine that wrote it. Readers report failure through the stream's state.
+
+template<typename T>
+inline void write_value(std::ostream &out, const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written as bytes");
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template<typename T>
+inline bool read_value(std::istream &in, T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read as bytes");
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+//A vector of plain values, prefixed by its length
+template<typename T>
+inline void write_vector(std::ostream &out, const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written as bytes");
+    write_value<uint64_t>(out, values.size());
+    if(!values.empty()) {
+        out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+}
+
+//limit guards against a corrupt length asking for an absurd allocation
+template<typename T>
+inline bool read_vector(std::istream &in, std::vector<T> &values, uint64_t limit = UINT32_MAX) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read as bytes");
+    uint64_t count = 0;
+    if(!read_value(in, count) || count > limit) {
+        in.setstate(std::ios::failbit);
+        return false;
+    }
+    values.resize(count);
+    return count == 0 || static_cast<bool>(in.read(reinterpret_cast<char *>(values.data()), count * sizeof(T)));
+}
+
+inline void write_string(std::ostream &out, const std::string &text) {
+    write_vector(out, std::vector<char>(text.begin(), text.end()));
+}
+
+inline bool read_string(std::istream &in, std::string &text) {
+    std::vector<char> characters;
+    if(!read_vector(in, characters, 1 << 20)) {
+        return false;
+    }
+    text.assign(characters.begin(), characters.end());
+    return true;
+}
+
+#endif
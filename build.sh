@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+set -e
+
+mkdir -p bin
+
+echo "Compiling simulator (EP, RR, EP_RR, MLFQ, SJF and SRTF schedulers)..."
+g++ -std=c++17 -Wall -Wextra -O2 -pthread \
+    main.cpp \
+    interrupts_student1_student2_EP.cpp \
+    interrupts_student1_student2_RR.cpp \
+    interrupts_student1_student2_EP_RR.cpp \
+    interrupts_student1_student2_MLFQ.cpp \
+    interrupts_student1_student2_SJF.cpp \
+    -o bin/main
+
+echo "Compiling trace converter..."
+g++ -std=c++17 -Wall -Wextra -O2 \
+    trace_to_text.cpp \
+    -o bin/trace_to_text
+
+echo "Compiling workload generator..."
+g++ -std=c++17 -Wall -Wextra -O2 \
+    generate_workload.cpp \
+    -o bin/generate_workload
+
+echo "Compiling regression harness..."
+g++ -std=c++17 -Wall -Wextra -O2 \
+    regress.cpp \
+    -o bin/regress
+
+echo "Compiling benchmark..."
+g++ -std=c++17 -Wall -Wextra -O2 \
+    bench.cpp \
+    interrupts_student1_student2_EP.cpp \
+    interrupts_student1_student2_RR.cpp \
+    interrupts_student1_student2_EP_RR.cpp \
+    interrupts_student1_student2_MLFQ.cpp \
+    interrupts_student1_student2_SJF.cpp \
+    -o bin/bench
+
+echo "✅ Build finished. Binaries in ./bin:"
+ls bin
@@ -0,0 +1,88 @@
+/**
+ * @file generate_workload.cpp
+ * Synthetic workload generator for SYSC4001 A3 P1: writes input files in the
+ * add_process format ("PID, size, arrival_time, processing_time, io_freq, io_duration")
+ * for scale testing
+ */
+
+#include "workload_generator.hpp"
+
+static void usage() {
+    std::cout << "To run the program, do: ./bin/generate_workload [options]\n"
+              << "  --processes <n>          number of processes (default 1000)\n"
+              << "  --seed <n>               random seed (default 1)\n"
+              << "  --arrival <spec>         poisson:<gap> | bursty:<gap>:<burst> | fixed:<gap> (default poisson:10)\n"
+              << "  --cpu <dist>             total CPU time per process (default exp:100)\n"
+              << "  --io-freq <dist>         CPU ms between I/Os, 0 = none (default none)\n"
+              << "  --io-duration <dist>     length of each I/O (default uniform:1:10)\n"
+              << "  --size <dist>            memory size in MB (default: fits a random partition)\n"
+              << "  --memory <file>          partition table the default sizes must fit (default built-in)\n"
+              << "  --output <file>          write here instead of standard output\n"
+              << "  <dist> is none | fixed:<v> | uniform:<low>:<high> | exp:<mean>" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    workload_spec spec;
+    std::string output_path;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            usage();
+            return -1;
+        }
+        std::string value = argv[++i];
+
+        bool ok = true;
+        try {
+            if (arg == "--processes")        spec.processes = std::stoll(value);
+            else if (arg == "--seed")        spec.seed = std::stoull(value);
+            else if (arg == "--arrival")     ok = parse_arrivals(value, spec.arrivals);
+            else if (arg == "--cpu")         ok = parse_distribution(value, spec.cpu);
+            else if (arg == "--io-freq")     ok = parse_distribution(value, spec.io_freq);
+            else if (arg == "--io-duration") ok = parse_distribution(value, spec.io_duration);
+            else if (arg == "--size")        ok = parse_distribution(value, spec.size);
+            else if (arg == "--memory")      ok = (spec.partitions.clear(), load_memory_partitions(value, spec.partitions));
+            else if (arg == "--output")      output_path = value;
+            else                             ok = false;
+        } catch (const std::exception &) {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: bad value for " << arg << ": " << value << std::endl;
+            usage();
+            return -1;
+        }
+    }
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        output_file.open(output_path);
+        if (!output_file.is_open()) {
+            std::cerr << "Error: Unable to open file: " << output_path << std::endl;
+            return -1;
+        }
+    }
+    std::ostream &out = output_path.empty() ? std::cout : output_file;
+
+    // record how the file was made so it can be regenerated
+    out << "# generate_workload";
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--output") { i++; continue; }
+        out << " " << argv[i];
+    }
+    out << "\n";
+
+    std::string line;
+    for (workload_generator generator(spec); !generator.done();) {
+        PCB process = generator.next();
+        line = std::to_string(process.PID) + ", " + std::to_string(process.size) + ", "
+             + std::to_string(process.arrival_time) + ", " + std::to_string(process.processing_time) + ", "
+             + std::to_string(process.io_freq) + ", " + std::to_string(process.io_duration) + "\n";
+        out << line;
+    }
+
+    return 0;
+}
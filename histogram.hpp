@@ -0,0 +1,84 @@
+/**
+ * @file histogram.hpp
+ * @brief fixed-size latency histograms for the SYSC4001 A3 P1 metrics
+ *
+ */
+
+#ifndef HISTOGRAM_HPP_
+#define HISTOGRAM_HPP_
+
+#include<vector>
+#include<cstdint>
+#include<algorithm>
+
+//HDR-style histogram of unsigned 32-bit values (times in ms). Values below 128 get
+//a bucket each; above that every power of two is split into 64 buckets, so any
+//percentile is within 1/64 of the true value. The bucket array has a fixed size,
+//however many values are recorded, so it works for million-process runs.
+class log_histogram {
+public:
+    log_histogram() : counts(bucket_count, 0) {}
+
+    void record(uint32_t value) {
+        counts[bucket_of(value)]++;
+        total++;
+        sum += value;
+        largest = std::max(largest, value);
+    }
+
+    uint64_t count() const { return total; }
+    uint32_t max() const { return largest; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    //Smallest bucket bound that at least pct percent of the values are <= to
+    //(0 < pct <= 100), capped at the largest value recorded
+    uint32_t percentile(double pct) const {
+        if(total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(pct / 100.0 * total + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, total));
+
+        uint64_t seen = 0;
+        for(size_t bucket = 0; bucket < bucket_count; bucket++) {
+            seen += counts[bucket];
+            if(seen >= rank) {
+                return std::min(upper_bound_of(bucket), largest);
+            }
+        }
+        return largest;
+    }
+
+private:
+    static constexpr int        sub_bucket_bits = 7;
+    static constexpr uint32_t   sub_buckets = 1u << sub_bucket_bits;    // exact buckets for 0..127
+    static constexpr uint32_t   half = sub_buckets / 2;                 // buckets per power of two above that
+    static constexpr size_t     bucket_count = sub_buckets + (32 - sub_bucket_bits) * half;
+
+    static size_t bucket_of(uint32_t value) {
+        if(value < sub_buckets) return value;
+        int top_bit = 31 - count_leading_zeros(value);
+        int shift = top_bit - sub_bucket_bits + 1;
+        return sub_buckets + (shift - 1) * half + ((value >> shift) - half);
+    }
+
+    static uint32_t upper_bound_of(size_t bucket) {
+        if(bucket < sub_buckets) return static_cast<uint32_t>(bucket);
+        int shift = static_cast<int>((bucket - sub_buckets) / half) + 1;
+        uint64_t mantissa = half + (bucket - sub_buckets) % half;
+        return static_cast<uint32_t>(((mantissa + 1) << shift) - 1);
+    }
+
+    static int count_leading_zeros(uint32_t value) {
+        int zeros = 0;
+        for(uint32_t bit = 1u << 31; bit && !(value & bit); bit >>= 1) {
+            zeros++;
+        }
+        return zeros;
+    }
+
+    std::vector<uint64_t>   counts;
+    uint64_t                total = 0;
+    uint64_t                sum = 0;
+    uint32_t                largest = 0;
+};
+
+#endif
@@ -12,12 +12,24 @@
 #include<fstream>
 #include<string>
 #include<vector>
+#include<deque>
+#include<set>
 #include<tuple>
 #include<random>
 #include<utility>
 #include<sstream>
 #include<iomanip>
 #include<algorithm>
+#include<memory>
+#include<charconv>
+#include<cstring>
+#include<cstdint>
+#include<type_traits>
+#include<cassert>
+
+#include "memory_manager.hpp"
+#include "binary_io.hpp"
+#include "arena.hpp"
 
 //An enumeration of states to make assignment easier
 enum states {
@@ -29,10 +41,10 @@ enum states {
     NOT_ASSIGNED
 };
 
-// make this inline so we can include in multiple .cpp files
-inline std::ostream& operator<<(std::ostream& os, const enum states& s) { //Overloading the << operator to make printing of the enum easier
+const int NUM_STATES = NOT_ASSIGNED + 1;
 
-    std::string state_names[] = {
+inline const char *state_name(states s) {
+    static const char *const state_names[] = {
                                 "NEW",
                                 "READY",
                                 "RUNNING",
@@ -40,43 +52,175 @@ inline std::ostream& operator<<(std::ostream& os, const enum states& s) { //Over
                                 "TERMINATED",
                                 "NOT_ASSIGNED"
     };
-    return (os << state_names[s]);
+    return state_names[s];
 }
 
-struct memory_partition{
-    unsigned int    partition_number;
-    unsigned int    size;
-    int             occupied;
-};
-
-// inline variable (C++17) so it can appear in multiple TUs
-inline memory_partition memory_paritions[] = {
-    {1, 40, -1},
-    {2, 25, -1},
-    {3, 15, -1},
-    {4, 10, -1},
-    {5, 8, -1},
-    {6, 2, -1}
-};
+// make this inline so we can include in multiple .cpp files
+inline std::ostream& operator<<(std::ostream& os, const enum states& s) { //Overloading the << operator to make printing of the enum easier
+    return (os << state_name(s));
+}
 
-struct PCB{
+//The part of a PCB read or written on every scheduling decision or dispatch.
+//process_table keeps it apart from the rest, one per cache line (see
+//process_table::state_line), so it must stay within 64 bytes.
+struct process_state {
     int             PID;
-    unsigned int    size;
-    unsigned int    arrival_time;
-    int             start_time;
-    unsigned int    processing_time;
+    enum states     state;
     unsigned int    remaining_time;
+    unsigned int    priority = 0;       // level/priority a policy keeps for the process (0 = highest)
+    unsigned int    priority_stamp = 0; // policy-defined stamp of when it was set
     int             partition_number;
-    enum states     state;
+    int             cpu = 0;            // CPU whose ready queue it is in, or that it last ran on
+    unsigned int    burst_start = 0;    // time it started (or will start) using the CPU it runs on
+    unsigned int    cpu_since_io = 0;   // CPU time used since the last I/O
     unsigned int    io_freq;
+    unsigned int    last_burst = 0;     // CPU time used the last time it was on a CPU
+    unsigned int    ready_since = 0;    // time the process last became READY
+    unsigned int    arrival_time;       // EP's key on every enqueue
+    int             start_time;         // -1 until the first dispatch
+    int             totalWaitTime = 0;  // total time spent in READY queues, added to on every dispatch
+};
+
+//The rest of a PCB: read on admission, I/O and termination, and by the metrics
+struct process_info {
+    unsigned int    size;
+    unsigned int    processing_time;
     unsigned int    io_duration;
 
     // --- metrics fields ---
     int finishTime = 0;          // time when the job fully completed
-    int totalWaitTime = 0;       // total time spent in READY queues
-    std::vector<int> ioStartTimes; // timestamps of each I/O start
 };
 
+//A process as the workload loaders build it and a finished run hands it back. Every
+//field is a plain value, so copying a PCB never allocates; history that only grows
+//(I/O start times) lives in process_history instead.
+struct PCB : process_state, process_info {};
+
+static_assert(std::is_trivially_copyable<PCB>::value, "PCBs are copied and saved as plain bytes");
+
+//What a process did over a run, kept apart from its PCB because the scheduler never
+//reads it. The entries live in the run's arena (process_table::storage).
+struct process_history {
+    arena_list<int> ioStartTimes; // timestamps of each I/O start
+};
+
+//Handle of the idle CPU / "no process"
+const int NO_PROCESS = -1;
+
+//Every process of one simulation, stored once for the whole run. The ready queue,
+//the running slot and the event queue refer to a process by its handle (its index
+//in the table), so a state change is an in-place update instead of a PCB copy.
+//Each PCB is split in two arrays: table[handle] is its process_state, which every
+//scheduling decision and dispatch reads, and info[handle] the rest, which only
+//admission, I/O and termination touch.
+//The table also keeps a live count of processes per state; always change a
+//process's state through set_state() so the counts stay correct.
+struct process_table {
+    //The queues reach processes in no particular order, so each process_state gets a
+    //cache line of its own and reading one never touches two lines
+    struct alignas(64) state_line {
+        process_state state;
+    };
+    static_assert(sizeof(state_line) == 64, "a process_state must fit in one cache line");
+
+    std::vector<state_line> lines;
+    std::vector<process_info> info;         // by handle, like lines
+    std::vector<process_history> history;   // by handle, like lines
+    std::shared_ptr<arena> storage;         // holds the histories' entries
+    int state_count[NUM_STATES] = {};
+
+    //Without an arena the table makes its own
+    explicit process_table(const std::vector<PCB> &list_processes, std::shared_ptr<arena> storage = nullptr)
+        : history(list_processes.size()), storage(storage ? std::move(storage) : std::make_shared<arena>()) {
+        lines.reserve(list_processes.size());
+        info.reserve(list_processes.size());
+        for(const PCB &process : list_processes) {
+            lines.push_back({process});
+            info.push_back(process);
+            state_count[process.state]++;
+        }
+    }
+
+    process_state &operator[](int handle) { return lines[handle].state; }
+    const process_state &operator[](int handle) const { return lines[handle].state; }
+
+    int size() const { return static_cast<int>(lines.size()); }
+
+    //Every process put back together, in handle order
+    std::vector<PCB> processes() const {
+        std::vector<PCB> list_processes(lines.size());
+        for(size_t handle = 0; handle < lines.size(); handle++) {
+            static_cast<process_state &>(list_processes[handle]) = lines[handle].state;
+            static_cast<process_info &>(list_processes[handle]) = info[handle];
+        }
+        return list_processes;
+    }
+
+    void set_state(int handle, states new_state) {
+        state_count[lines[handle].state.state]--;
+        state_count[new_state]++;
+        lines[handle].state.state = new_state;
+    }
+
+    int count(states state) const { return state_count[state]; }
+};
+
+//Ready queue ordered by a priority key (smallest key is served first), kept as a
+//binary heap of handles so push and pop are O(log n). Processes with equal keys
+//leave in FIFO order.
+class priority_ready_queue {
+public:
+    void push(int handle, long long key) {
+        heap.push_back({key, next_seq++, handle});
+        std::push_heap(heap.begin(), heap.end(), after);
+    }
+
+    int pop() {
+        std::pop_heap(heap.begin(), heap.end(), after);
+        int handle = heap.back().handle;
+        heap.pop_back();
+        return handle;
+    }
+
+    int top() const { return heap.front().handle; }
+    long long top_key() const { return heap.front().key; }
+
+    bool empty() const { return heap.empty(); }
+    int size() const { return static_cast<int>(heap.size()); }
+
+    void clear() {
+        heap.clear();
+        next_seq = 0;
+    }
+
+    //Queued handles in the order they would be popped
+    std::vector<int> in_order() const {
+        std::vector<entry> sorted = heap;
+        std::sort(sorted.begin(), sorted.end(), [](const entry &first, const entry &second) {
+            return after(second, first);
+        });
+        std::vector<int> handles;
+        for(const entry &item : sorted) {
+            handles.push_back(item.handle);
+        }
+        return handles;
+    }
+
+private:
+    struct entry {
+        long long       key;
+        unsigned int    seq;    // push order, for FIFO among equal keys
+        int             handle;
+    };
+
+    static bool after(const entry &first, const entry &second) {
+        if(first.key != second.key) return first.key > second.key;
+        return first.seq > second.seq;
+    }
+
+    std::vector<entry> heap;
+    unsigned int next_seq = 0;
+};
 
 //------------------------------------HELPER FUNCTIONS FOR THE SIMULATOR------------------------------
 // Following function was taken from stackoverflow; helper function for splitting strings
@@ -94,8 +238,19 @@ inline std::vector<std::string> split_delim(std::string input, std::string delim
     return tokens;
 }
 
+//Splits a line by whitespace into tokens
+inline std::vector<std::string> split_whitespace(const std::string &line) {
+    std::vector<std::string> tokens;
+    std::stringstream ss(line);
+    std::string token;
+    while (ss >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
 //Function that takes a queue as an input and outputs a string table of PCBs
-inline std::string print_PCB(std::vector<PCB> _PCB) {
+inline std::string print_PCB(const std::vector<PCB> &_PCB) {
     const int tableWidth = 83;
 
     std::stringstream buffer;
@@ -149,15 +304,14 @@ inline std::string print_PCB(std::vector<PCB> _PCB) {
 }
 
 //Overloaded function that takes a single PCB as input
-inline std::string print_PCB(PCB _PCB) {
-    std::vector<PCB> temp;
-    temp.push_back(_PCB);
-    return print_PCB(temp);
+inline std::string print_PCB(const PCB &_PCB) {
+    return print_PCB(std::vector<PCB>{_PCB});
 }
 
-inline std::string print_exec_header() {
+//cpu_column adds a CPU column, for runs with more than one simulated CPU
+inline std::string print_exec_header(bool cpu_column = false) {
 
-    const int tableWidth = 49;
+    const int tableWidth = cpu_column ? 55 : 49;
 
     std::stringstream buffer;
 
@@ -169,8 +323,12 @@ inline std::string print_exec_header() {
             << std::setfill(' ') << std::setw(18) << "Time of Transition"
             << std::setw(2) << "|"
             << std::setfill(' ') << std::setw(3) << "PID"
-            << std::setw(2) << "|"
-            << std::setfill(' ') << std::setw(10) << "Old State"
+            << std::setw(2) << "|";
+    if(cpu_column) {
+        buffer  << std::setfill(' ') << std::setw(3) << "CPU"
+                << std::setw(2) << "|";
+    }
+    buffer  << std::setfill(' ') << std::setw(10) << "Old State"
             << std::setw(2) << "|"
             << std::setfill(' ') << std::setw(10) << "New State"
             << std::setw(2) << "|" << std::endl;
@@ -182,27 +340,47 @@ inline std::string print_exec_header() {
 
 }
 
-inline std::string print_exec_status(unsigned int current_time, int PID, states old_state, states new_state) {
-
-    const int tableWidth = 49;
+//Appends text right-aligned in a field of the given width, like std::setw does
+inline void append_field(std::string &buffer, const char *text, size_t length, size_t width) {
+    if(length < width) {
+        buffer.append(width - length, ' ');
+    }
+    buffer.append(text, length);
+}
 
-    std::stringstream buffer;
+//Appends one row of the execution table to buffer, without any temporary strings.
+//A cpu of -1 leaves out the CPU column.
+inline void append_exec_status(std::string &buffer, unsigned int current_time, int PID,
+                               states old_state, states new_state, int cpu = -1) {
+    char digits[16];
+    char *end;
 
-    buffer  << "|"
-            << std::setfill(' ') << std::setw(18) << current_time
-            << std::setw(2) << "|"
-            << std::setw(3) << PID
-            << std::setw(2) << "|"
-            << std::setw(10) << old_state
-            << std::setw(2) << "|"
-            << std::setw(10) << new_state
-            << std::setw(2) << "|" << std::endl;
+    buffer += '|';
+    end = std::to_chars(digits, digits + sizeof(digits), current_time).ptr;
+    append_field(buffer, digits, end - digits, 18);
+    buffer += " |";
+    end = std::to_chars(digits, digits + sizeof(digits), PID).ptr;
+    append_field(buffer, digits, end - digits, 3);
+    buffer += " |";
+    if(cpu >= 0) {
+        end = std::to_chars(digits, digits + sizeof(digits), cpu).ptr;
+        append_field(buffer, digits, end - digits, 3);
+        buffer += " |";
+    }
+    append_field(buffer, state_name(old_state), std::strlen(state_name(old_state)), 10);
+    buffer += " |";
+    append_field(buffer, state_name(new_state), std::strlen(state_name(new_state)), 10);
+    buffer += " |\n";
+}
 
-    return buffer.str();
+inline std::string print_exec_status(unsigned int current_time, int PID, states old_state, states new_state) {
+    std::string buffer;
+    append_exec_status(buffer, current_time, PID, old_state, new_state);
+    return buffer;
 }
 
-inline std::string print_exec_footer() {
-    const int tableWidth = 49;
+inline std::string print_exec_footer(bool cpu_column = false) {
+    const int tableWidth = cpu_column ? 55 : 49;
     std::stringstream buffer;
 
     // Print bottom border
@@ -211,15 +389,6 @@ inline std::string print_exec_footer() {
     return buffer.str();
 }
 
-//Synchronize the process in the process queue
-inline void sync_queue(std::vector<PCB> &process_queue, PCB _process) {
-    for(auto &process : process_queue) {
-        if(process.PID == _process.PID) {
-            process = _process;
-        }
-    }
-}
-
 //Writes a string to a file
 inline void write_output(std::string execution, const char* filename) {
     std::ofstream output_file(filename);
@@ -235,37 +404,144 @@ inline void write_output(std::string execution, const char* filename) {
     std::cout << "Output generated in " << filename << ".txt" << std::endl;
 }
 
-//--------------------------------------------FUNCTIONS FOR THE "OS"-------------------------------------
+//Binary trace file: a trace_header followed by one fixed-size trace_record per
+//transition, in host byte order (little-endian on x86). trace_to_text turns it back
+//into the usual table.
+struct trace_header {
+    char            magic[8];       // "SIMTRACE"
+    uint32_t        version;
+    uint32_t        record_size;    // sizeof(trace_record)
+};
 
+struct trace_record {
+    uint32_t        time;
+    int32_t         PID;
+    uint8_t         old_state;
+    uint8_t         new_state;
+    uint16_t        cpu;            // CPU + 1 on multi-CPU runs, 0 otherwise
+};
 
-//Assign memory partition to program
-inline bool assign_memory(PCB &program) {
-    int size_to_fit = program.size;
-    int available_size = 0;
+static_assert(sizeof(trace_header) == 16 && sizeof(trace_record) == 12, "trace layout must not change");
 
-    for(int i = 5; i >= 0; i--) {
-        available_size = memory_paritions[i].size;
+const char TRACE_MAGIC[8] = {'S', 'I', 'M', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TRACE_VERSION = 1;
 
-        if(size_to_fit <= available_size && memory_paritions[i].occupied == -1) {
-            memory_paritions[i].occupied = program.PID;
-            program.partition_number = memory_paritions[i].partition_number;
-            return true;
+//Where an execution_log sends the table
+enum log_target {
+    LOG_TO_MEMORY,  // keep the whole table, see str()
+    LOG_TO_FILE,    // stream it to a file as the simulation runs
+    LOG_TO_TRACE,   // stream binary trace records to a file instead of text
+    LOG_DISCARD     // don't produce a table at all
+};
+
+//Sink for the execution table. Rows are formatted straight into one reusable buffer,
+//and a file log writes that buffer out every chunk_size bytes, so memory use stays
+//flat no matter how many transitions a run makes. The bytes are the same as
+//print_exec_header() + print_exec_status() rows + print_exec_footer(). A trace log
+//writes the same transitions as 12-byte binary records instead. The CPU column
+//(cpu_column in header()) is only there for runs with more than one CPU.
+class execution_log {
+public:
+    static const size_t chunk_size = 64 * 1024;
+
+    explicit execution_log(log_target target = LOG_TO_MEMORY, const std::string &path = "")
+        : target(target) {
+        if(target == LOG_TO_FILE || target == LOG_TO_TRACE) {
+            output_file.open(path, target == LOG_TO_TRACE ? std::ios::binary : std::ios::out);
+            if(!output_file.is_open()) {
+                std::cerr << "Error opening file!" << std::endl;
+                this->target = LOG_DISCARD;
+                open_failed = true;
+            }
+            buffer.reserve(chunk_size + 128);
         }
     }
 
-    return false;
+    ~execution_log() { flush(); }
+
+    void header(bool cpu_column = false) {
+        show_cpu = cpu_column;
+        if(target == LOG_TO_TRACE) {
+            trace_header file_header{};
+            std::memcpy(file_header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+            file_header.version = TRACE_VERSION;
+            file_header.record_size = sizeof(trace_record);
+            buffer.append(reinterpret_cast<const char *>(&file_header), sizeof(file_header));
+        }
+        else if(target != LOG_DISCARD) {
+            buffer += print_exec_header(show_cpu);
+        }
+    }
+
+    void status(unsigned int current_time, int PID, states old_state, states new_state, int cpu = 0) {
+        if(target == LOG_DISCARD) return;
+
+        if(target == LOG_TO_TRACE) {
+            trace_record record{current_time, PID, static_cast<uint8_t>(old_state),
+                                static_cast<uint8_t>(new_state), static_cast<uint16_t>(show_cpu ? cpu + 1 : 0)};
+            buffer.append(reinterpret_cast<const char *>(&record), sizeof(record));
+        } else {
+            append_exec_status(buffer, current_time, PID, old_state, new_state, show_cpu ? cpu : -1);
+        }
+        if(target != LOG_TO_MEMORY && buffer.size() >= chunk_size) {
+            flush();
+        }
+    }
+
+    void footer() {
+        if(target == LOG_DISCARD) return;
+
+        if(target != LOG_TO_TRACE) {
+            buffer += print_exec_footer(show_cpu);
+        }
+        flush();
+    }
+
+    //Writes whatever is buffered to the file (no-op for a memory log)
+    void flush() {
+        if((target == LOG_TO_FILE || target == LOG_TO_TRACE) && !buffer.empty()) {
+            output_file.write(buffer.data(), buffer.size());
+            output_file.flush();
+            buffer.clear();
+        }
+    }
+
+    //The table kept by a LOG_TO_MEMORY log
+    const std::string &str() const { return buffer; }
+
+    //False if the file couldn't be opened
+    bool good() const { return !open_failed; }
+
+private:
+    log_target      target;
+    bool            open_failed = false;
+    bool            show_cpu = false;
+    std::string     buffer;
+    std::ofstream   output_file;
+};
+
+//--------------------------------------------FUNCTIONS FOR THE "OS"-------------------------------------
+
+
+//Assign memory partition to program
+inline bool assign_memory(process_state &program, unsigned int size, memory_manager &memory) {
+    int partition_number = memory.allocate(program.PID, size);
+    if(partition_number == -1) {
+        return false;
+    }
+
+    program.partition_number = partition_number;
+    return true;
 }
 
 //Free a memory partition
-inline bool free_memory(PCB &program){
-    for(int i = 5; i >= 0; i--) {
-        if(program.PID == memory_paritions[i].occupied) {
-            memory_paritions[i].occupied = -1;
-            program.partition_number = -1;
-            return true;
-        }
+inline bool free_memory(process_state &program, memory_manager &memory){
+    if(!memory.release(program.partition_number)) {
+        return false;
     }
-    return false;
+
+    program.partition_number = -1;
+    return true;
 }
 
 //Convert a list of strings into a PCB
@@ -285,46 +561,864 @@ inline PCB add_process(std::vector<std::string> tokens) {
     return process;
 }
 
-//Returns true if all processes in the queue have terminated
-inline bool all_process_terminated(std::vector<PCB> processes) {
+//Returns true if all processes in the table have terminated
+inline bool all_process_terminated(const process_table &table) {
+    return table.count(TERMINATED) == table.size();
+}
 
-    for(auto process : processes) {
-        if(process.state != TERMINATED) {
+//Terminates a given process
+inline void terminate_process(process_table &table, int running, memory_manager &memory,
+                              unsigned int current_time) {
+    process_state &process = table[running];
+    process.remaining_time = 0;
+    table.info[running].finishTime = current_time;
+    table.set_state(running, TERMINATED);
+    free_memory(process, memory);
+}
+
+//set the process picked by the scheduler to runnning
+inline void run_process(process_table &table, int running, unsigned int current_time) {
+    process_state &process = table[running];
+    if(process.start_time == -1)
+        process.start_time = current_time;
+    process.totalWaitTime += current_time - process.ready_since;
+    table.set_state(running, RUNNING);
+}
+
+//Puts a process in READY and starts counting its time in the ready queue
+inline void make_ready(process_table &table, int handle, unsigned int current_time) {
+    table[handle].ready_since = current_time;
+    table.set_state(handle, READY);
+}
+
+inline void idle_CPU(int &running) {
+    running = NO_PROCESS;
+}
+
+//--------------------------------------------DISCRETE-EVENT ENGINE-------------------------------------
+
+//Kinds of events the simulator reacts to. Events that fall on the same time
+//are handled in this order, which is the order the old 1 ms loop used
+//(the running process finishes its tick before new arrivals are admitted)
+enum event_type {
+    COMPLETION,
+    IO_REQUEST,
+    QUANTUM_EXPIRY,
+    IO_DONE,
+    ARRIVAL
+};
+
+struct sim_event {
+    unsigned int    time;
+    event_type      type;
+    int             process;    // handle in the process table
+    unsigned int    seq;        // insertion order, breaks ties between equal events
+};
+
+//Min-heap of pending events ordered by (time, type, insertion order)
+class event_queue {
+public:
+    //Schedules an event and returns its sequence number so it can be recognised later
+    unsigned int push(unsigned int time, event_type type, int process) {
+        heap.push_back({time, type, process, next_seq});
+        std::push_heap(heap.begin(), heap.end(), later);
+        return next_seq++;
+    }
+
+    sim_event pop() {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        sim_event event = heap.back();
+        heap.pop_back();
+        return event;
+    }
+
+    bool empty() const { return heap.empty(); }
+
+    unsigned int next_time() const { return heap.front().time; }
+
+    //Checkpoints: the pending events and the next sequence number, so events
+    //scheduled after a resume still sort exactly as they would have
+    void save(std::ostream &out) const {
+        write_vector(out, heap);
+        write_value(out, next_seq);
+    }
+
+    bool load(std::istream &in, int handles) {
+        if(!read_vector(in, heap) || !read_value(in, next_seq)) {
             return false;
         }
+        for(const sim_event &event : heap) {
+            if(event.process < 0 || event.process >= handles || event.type > ARRIVAL) {
+                return false;
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), later);
+        return true;
+    }
+
+private:
+    static bool later(const sim_event &first, const sim_event &second) {
+        if(first.time != second.time) return first.time > second.time;
+        if(first.type != second.type) return first.type > second.type;
+        return first.seq > second.seq;
     }
 
+    std::vector<sim_event> heap;
+    unsigned int next_seq = 1;  // 0 is never handed out, so it can mean "no event"
+};
+
+//Schedules one arrival event per process so the clock can jump straight to them
+inline void schedule_arrivals(event_queue &events, const process_table &table) {
+    for(int handle = 0; handle < table.size(); handle++) {
+        events.push(table[handle].arrival_time, ARRIVAL, handle);
+    }
+}
+
+//Schedules the end of the running process's CPU burst: it completes, issues its next
+//I/O (every io_freq ms of CPU) or its time slice runs out, whichever comes first.
+//A quantum or io_freq of 0 means no time slice or no I/O.
+//Returns the scheduled event; its sequence number identifies it later.
+inline sim_event schedule_burst(event_queue &events, const process_table &table, int running,
+                                unsigned int current_time, unsigned int quantum) {
+    const process_state &process = table[running];
+
+    //The old loop always ran at least one tick, even for a process with no CPU time left
+    unsigned int burst = std::max(process.remaining_time, 1u);
+    event_type type = COMPLETION;
+
+    if(process.io_freq != 0 && process.io_freq - process.cpu_since_io < burst) {
+        burst = process.io_freq - process.cpu_since_io;
+        type = IO_REQUEST;
+    }
+    if(quantum != 0 && quantum < burst) {
+        burst = quantum;
+        type = QUANTUM_EXPIRY;
+    }
+    sim_event end{current_time + burst, type, running, 0};
+    end.seq = events.push(end.time, end.type, running);
+    return end;
+}
+
+//Charges the CPU time used since its burst_start to the running process and returns it.
+//burst_start is later than the dispatch when overhead had to be paid first.
+inline unsigned int charge_burst(process_state &running, unsigned int current_time) {
+    unsigned int used = current_time > running.burst_start
+                      ? std::min(running.remaining_time, current_time - running.burst_start) : 0;
+    running.remaining_time -= used;
+    running.cpu_since_io += used;
+    running.last_burst = used;
+    return used;
+}
+
+//Blocks the running process for I/O. It sits in WAITING for io_duration ms; the
+//IO_DONE event in the (time-ordered) event queue is what wakes it up again.
+inline void start_io(process_table &table, int running, event_queue &events,
+                     unsigned int current_time, execution_log &log) {
+    process_state &process = table[running];
+    log.status(current_time, process.PID, RUNNING, WAITING, process.cpu);
+
+    table.set_state(running, WAITING);
+    process.cpu_since_io = 0;
+    table.history[running].ioStartTimes.push_back(*table.storage, current_time);
+
+    events.push(current_time + table.info[running].io_duration, IO_DONE, running);
+}
+
+//------------------------------------------SCHEDULING POLICIES-----------------------------------------
+
+//Interface every scheduling policy implements. The engine owns the clock, the process
+//table, memory and the event queue; a policy owns its ready queue and decides who runs.
+//Every hook that hands a process to the policy is called after the process is READY.
+//On a multi-CPU run every CPU has its own policy object (see clone()).
+class scheduler_policy {
+public:
+    virtual ~scheduler_policy() = default;
+
+    virtual std::string name() const = 0;
+
+    //A new policy of the same kind, for another CPU's ready queue
+    virtual std::unique_ptr<scheduler_policy> clone() const = 0;
+
+    //Called before every run; clears the ready queue and binds the policy to the table.
+    //A policy may keep per-process state in the PCB's priority fields, nothing else.
+    virtual void reset(process_table &table) = 0;
+
+    //Called with the current time before the engine admits, preempts or dispatches
+    virtual void on_clock(unsigned int) {}
+
+    //Puts a READY process in the ready queue. The on_* hooks below all default to this.
+    virtual void add_ready(int handle) = 0;
+
+    virtual void on_arrival(int handle) { add_ready(handle); }         // NEW -> READY
+    virtual void on_io_done(int handle) { add_ready(handle); }         // WAITING -> READY
+    virtual void on_quantum_expiry(int handle) { add_ready(handle); }  // time slice used up
+    virtual void on_preempt(int handle) { add_ready(handle); }         // should_preempt() said so
+    virtual void on_block(int) {}                                      // RUNNING -> WAITING
+
+    //Removes and returns the next process to run, or NO_PROCESS if none is ready
+    virtual int select_next() = 0;
+
+    //Number of processes in the ready queue
+    virtual size_t ready_count() const = 0;
+
+    //Checked after every batch of events while a process is running
+    virtual bool should_preempt(int) { return false; }
+
+    //Time slice for a process about to be dispatched; 0 = run until it completes or blocks
+    virtual unsigned int quantum(int) { return 0; }
+
+    //Checkpoints. queued() lists the ready queue in the order it would be served; a
+    //resumed run calls reset(), then load_state() with whatever save_state() wrote,
+    //then add_ready() for every listed process in that order.
+    virtual std::vector<int> queued() const = 0;
+    virtual void save_state(std::ostream &) const {}
+    virtual bool load_state(std::istream &) { return true; }
+};
+
+//How time-sliced policies pick the quantum of a process they dispatch
+enum quantum_mode {
+    FIXED_QUANTUM,  // always the configured quantum
+    BURST_QUANTUM,  // follows the recent CPU burst lengths: short for I/O-bound work, long for CPU hogs
+    QUEUE_QUANTUM   // splits target_latency between the ready processes, like a fair-share scheduler
+};
+
+inline const char *quantum_mode_name(quantum_mode mode) {
+    const char *names[] = {"fixed", "burst", "queue"};
+    return names[mode];
+}
+
+inline bool parse_quantum_mode(const std::string &name, quantum_mode &mode) {
+    for(int m = FIXED_QUANTUM; m <= QUEUE_QUANTUM; m++) {
+        if(name == quantum_mode_name(static_cast<quantum_mode>(m))) {
+            mode = static_cast<quantum_mode>(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+//Settings of the scheduling policies, passed to make_scheduler(); times in ms
+struct policy_config {
+    quantum_mode    mode = FIXED_QUANTUM;
+    unsigned int    quantum = 100;          // the fixed quantum, and the starting point of burst mode
+    unsigned int    min_quantum = 10;       // adaptive modes stay within [min_quantum, max_quantum]
+    unsigned int    max_quantum = 400;
+    unsigned int    target_latency = 400;   // queue mode: time for every ready process to get a turn
+
+    std::vector<unsigned int>   level_quanta = {10, 20, 40};    // MLFQ: quantum of each level, top first
+    unsigned int                boost_interval = 1000;          // MLFQ: everyone back to the top this often; 0 = never
+
+    bool            predict_bursts = false;     // SJF/SRTF: order by predicted next CPU burst, not remaining time
+    double          prediction_weight = 0.5;    // weight of the last burst in the exponential average
+    unsigned int    initial_prediction = 20;    // prediction for a process that hasn't run yet
+};
+
+//Works out quanta for a policy. Burst mode keeps an exponential average of the
+//bursts processes actually used (until they blocked, were preempted or ran out
+//their slice) and hands out 1.25 times that, so most I/O-bound bursts finish
+//within one slice while CPU-bound processes see their slice grow.
+class time_slicer {
+public:
+    explicit time_slicer(const policy_config &config = {})
+        : config(config), average_burst(config.quantum) {}
+
+    const policy_config &settings() const { return config; }
+
+    void reset() { average_burst = config.quantum; }
+
+    //Records the burst a process just used (its PCB's last_burst)
+    void observe(unsigned int burst) {
+        if(config.mode == BURST_QUANTUM) {
+            average_burst = 0.5 * average_burst + 0.5 * burst;
+        }
+    }
+
+    //Checkpoints: the average is all that changes during a run
+    void save(std::ostream &out) const { write_value(out, average_burst); }
+    bool load(std::istream &in) { return read_value(in, average_burst); }
+
+    //Quantum for the next dispatch, given how many processes are still waiting
+    unsigned int quantum(size_t ready_count) const {
+        double slice = config.quantum;
+        if(config.mode == BURST_QUANTUM) {
+            slice = 1.25 * average_burst;
+        } else if(config.mode == QUEUE_QUANTUM) {
+            slice = static_cast<double>(config.target_latency) / (ready_count + 1);
+        } else {
+            return config.quantum;
+        }
+        slice = std::max<double>(config.min_quantum, std::min<double>(config.max_quantum, slice));
+        return std::max(1u, static_cast<unsigned int>(slice + 0.5));
+    }
+
+private:
+    policy_config   config;
+    double          average_burst;
+};
+
+//Factories, one per scheduler source file
+std::unique_ptr<scheduler_policy> make_EP_scheduler();
+std::unique_ptr<scheduler_policy> make_RR_scheduler(const policy_config &settings);
+std::unique_ptr<scheduler_policy> make_EP_RR_scheduler(const policy_config &settings);
+std::unique_ptr<scheduler_policy> make_MLFQ_scheduler(const policy_config &settings);
+std::unique_ptr<scheduler_policy> make_SJF_scheduler(const policy_config &settings);
+std::unique_ptr<scheduler_policy> make_SRTF_scheduler(const policy_config &settings);
+
+//Names accepted by make_scheduler(), in the order they are run by default
+inline const std::vector<std::string> scheduler_names = {"EP", "RR", "EP_RR", "MLFQ", "SJF", "SRTF"};
+
+//Builds the policy with the given name, or returns nullptr if there is none.
+//Each policy reads the settings it has a use for.
+inline std::unique_ptr<scheduler_policy> make_scheduler(const std::string &name,
+                                                        const policy_config &settings = {}) {
+    if(name == "EP")    return make_EP_scheduler();
+    if(name == "RR")    return make_RR_scheduler(settings);
+    if(name == "EP_RR") return make_EP_RR_scheduler(settings);
+    if(name == "MLFQ")  return make_MLFQ_scheduler(settings);
+    if(name == "SJF")   return make_SJF_scheduler(settings);
+    if(name == "SRTF")  return make_SRTF_scheduler(settings);
+    return nullptr;
+}
+
+//----------------------------------------------SIMULATION LOOP-----------------------------------------
+
+//Processes that have arrived but are not in memory yet. Nothing is polled: a new
+//arrival is tried once, and the ones still waiting are only retried after memory
+//has been freed. Either way they are tried in load order, like the old per-tick scan.
+struct admission_queue {
+    std::set<int>       waiting;                // handles, in load order
+    std::vector<int>    arrived;                // arrivals since the last admission pass
+    bool                memory_freed = false;   // memory was released since the last pass
+};
+
+//Time each simulated CPU spent on useful work and on overhead
+struct cpu_stats {
+    unsigned long long  busy_time = 0;          // CPU time charged to processes
+    unsigned long long  migrations = 0;         // dispatches of a process that last ran on another CPU
+    unsigned long long  migration_time = 0;     // time lost to those migrations
+    unsigned long long  context_switches = 0;   // dispatches of a different process than the last one
+    unsigned long long  switch_time = 0;        // time spent switching context
+    unsigned long long  interrupt_time = 0;     // time spent in I/O completion interrupts
+    unsigned long long  scheduler_time = 0;     // time spent picking the next process
+
+    unsigned long long overhead() const {
+        return migration_time + switch_time + interrupt_time + scheduler_time;
+    }
+};
+
+//Overhead charged to simulated time; all 0 (free) by default
+struct overhead_costs {
+    unsigned int    migration = 0;          // moving a process to another CPU
+    unsigned int    context_switch = 0;     // loading a different process than the one that ran last
+    unsigned int    interrupt = 0;          // handling an I/O completion
+    unsigned int    scheduler = 0;          // one scheduling decision
+};
+
+//One simulated CPU: its own ready queue (a policy object), the process it runs and
+//the event that ends that process's current burst
+struct cpu_core {
+    std::unique_ptr<scheduler_policy>   owned;              // clones for every CPU but the first
+    scheduler_policy                   *policy = nullptr;
+    int                                 running = NO_PROCESS;
+    int                                 last_process = NO_PROCESS;  // the one whose context is loaded
+    sim_event                           burst{};            // event that ends its burst; stale once preempted
+    unsigned int                        busy_until = 0;     // end of the overhead (switch, interrupt) it is paying
+    cpu_stats                           stats;
+};
+
+//CPU a newly admitted process is queued on: the one with the fewest processes,
+//counting the one it is running
+inline int least_loaded_cpu(const std::vector<cpu_core> &cores) {
+    int best = 0;
+    size_t best_load = SIZE_MAX;
+    for(int cpu = 0; cpu < static_cast<int>(cores.size()); cpu++) {
+        size_t load = cores[cpu].policy->ready_count() + (cores[cpu].running != NO_PROCESS);
+        if(load < best_load) {
+            best = cpu;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+//Work stealing: an idle CPU with an empty ready queue takes the next process of the
+//CPU with the longest ready queue. Returns NO_PROCESS if every queue is empty.
+inline int steal_process(std::vector<cpu_core> &cores, int thief) {
+    int victim = -1;
+    size_t longest = 0;
+    for(int cpu = 0; cpu < static_cast<int>(cores.size()); cpu++) {
+        size_t length = cores[cpu].policy->ready_count();
+        if(cpu != thief && length > longest) {
+            victim = cpu;
+            longest = length;
+        }
+    }
+    return victim == -1 ? NO_PROCESS : cores[victim].policy->select_next();
+}
+
+//Moves an arrived process into the ready queue of the least loaded CPU if it fits in memory
+inline bool admit_process(process_table &table, memory_manager &memory, std::vector<cpu_core> &cores,
+                          int handle, unsigned int current_time, execution_log &log) {
+    process_state &process = table[handle];
+    if(!assign_memory(process, table.info[handle].size, memory)) {
+        return false;
+    }
+
+    process.cpu = least_loaded_cpu(cores);
+    make_ready(table, handle, current_time);
+    cores[process.cpu].policy->on_arrival(handle);
+
+    log.status(current_time, process.PID, NEW, READY, process.cpu);
     return true;
 }
 
-//Terminates a given process
-inline void terminate_process(PCB &running, std::vector<PCB> &job_queue) {
-    running.remaining_time = 0;
-    running.state = TERMINATED;
-    free_memory(running);
-    sync_queue(job_queue, running);
-}
-
-//set the process in the ready queue to runnning
-inline void run_process(PCB &running, std::vector<PCB> &job_queue, std::vector<PCB> &ready_queue, unsigned int current_time) {
-    running = ready_queue.back();
-    ready_queue.pop_back();
-    running.start_time = current_time;
-    running.state = RUNNING;
-    sync_queue(job_queue, running);
-}
-
-inline void idle_CPU(PCB &running) {
-    running.start_time = 0;
-    running.processing_time = 0;
-    running.remaining_time = 0;
-    running.arrival_time = 0;
-    running.io_duration = 0;
-    running.io_freq = 0;
-    running.partition_number = 0;
-    running.size = 0;
-    running.state = NOT_ASSIGNED;
-    running.PID = -1;
-}
-
-#endif
+//Moves every process that has arrived and fits in memory into the ready queue
+inline void admit_arrivals(process_table &table, memory_manager &memory, admission_queue &admission,
+                           std::vector<cpu_core> &cores, unsigned int current_time, execution_log &log) {
+    if(admission.memory_freed) {
+        admission.waiting.insert(admission.arrived.begin(), admission.arrived.end());
+        for(auto handle = admission.waiting.begin(); handle != admission.waiting.end();) {
+            if(admit_process(table, memory, cores, *handle, current_time, log)) {
+                handle = admission.waiting.erase(handle);
+            } else {
+                ++handle;
+            }
+        }
+    } else {
+        //the ones already waiting can't fit now either, memory has only filled up since
+        for(int handle : admission.arrived) {
+            if(!admit_process(table, memory, cores, handle, current_time, log)) {
+                admission.waiting.insert(handle);
+            }
+        }
+    }
+
+    admission.arrived.clear();
+    admission.memory_freed = false;
+}
+
+//Returns a process whose I/O has completed to the ready queue of the CPU it last ran on
+inline void finish_io(process_table &table, int handle, scheduler_policy &policy,
+                      unsigned int current_time, execution_log &log) {
+    make_ready(table, handle, current_time);
+    policy.on_io_done(handle);
+
+    log.status(current_time, table[handle].PID, WAITING, READY, table[handle].cpu);
+}
+
+//Takes the running process off the CPU and hands it back to the policy
+inline void deschedule(process_table &table, int running, unsigned int current_time,
+                       execution_log &log) {
+    log.status(current_time, table[running].PID, RUNNING, READY, table[running].cpu);
+    make_ready(table, running, current_time);
+}
+
+//Starts a process on a CPU and schedules the end of its burst. The process only
+//starts using the CPU once the overhead is paid: an interrupt still being handled,
+//the scheduling decision, a context switch if another process ran last and a
+//migration if the process last ran on another CPU. The CPU stays busy with that
+//overhead even if the process is preempted before it starts, so the next dispatch
+//waits for it too.
+inline void dispatch(process_table &table, cpu_core &core, int cpu, int handle, event_queue &events,
+                     unsigned int current_time, const overhead_costs &costs, execution_log &log) {
+    process_state &process = table[handle];
+    process.burst_start = std::max(current_time, core.busy_until) + costs.scheduler;
+    core.stats.scheduler_time += costs.scheduler;
+    if(handle != core.last_process) {
+        process.burst_start += costs.context_switch;
+        core.stats.context_switches++;
+        core.stats.switch_time += costs.context_switch;
+        core.last_process = handle;
+    }
+    if(process.cpu != cpu) {
+        if(process.start_time != -1) {      // a process that never ran has nothing to move
+            process.burst_start += costs.migration;
+            core.stats.migrations++;
+            core.stats.migration_time += costs.migration;
+        }
+        process.cpu = cpu;
+    }
+    core.busy_until = process.burst_start;
+
+    run_process(table, handle, current_time);
+    log.status(current_time, process.PID, READY, RUNNING, cpu);
+
+    core.running = handle;
+    core.burst = schedule_burst(events, table, handle, process.burst_start, core.policy->quantum(handle));
+}
+
+//Charges an I/O completion interrupt to a CPU. The CPU is busy until the handler
+//returns, after any overhead it is still paying; a running process is paused for
+//the length of the handler, so the end of its burst moves back by as much.
+inline void handle_interrupt(process_table &table, cpu_core &core, event_queue &events,
+                             unsigned int current_time, unsigned int cost) {
+    core.stats.interrupt_time += cost;
+    core.busy_until = std::max(core.busy_until, current_time) + cost;
+    if(core.running == NO_PROCESS) {
+        return;
+    }
+    table[core.running].burst_start += cost;
+    core.burst.time += cost;
+    core.burst.seq = events.push(core.burst.time, core.burst.type, core.running);
+}
+
+//Most CPUs a run can simulate (every CPU has its own policy object)
+const unsigned int MAX_CPUS = 4096;
+
+//Everything about a run that isn't the workload or the policy
+struct simulation_config {
+    memory_mode                     memory_allocator = FIXED_PARTITIONS;
+    std::vector<memory_partition>   memory_partitions = default_memory_partitions;
+    unsigned int                    memory_size = 0;    // MB for variable/buddy memory; 0 = sum of the partitions
+    unsigned int                    cpus = 1;           // simulated CPUs, each with its own ready queue
+    overhead_costs                  costs;              // ms charged for switches, interrupts, decisions and migrations
+    policy_config                   policy;             // for make_scheduler(); the engine asks the policy
+    std::string                     checkpoint_path;    // if set, the state is saved here once the clock
+    unsigned int                    checkpoint_time = 0;    // reaches checkpoint_time
+};
+
+struct simulation_result {
+    std::vector<PCB>                processes;  // final state of every process
+    std::vector<process_history>    history;    // and what it did, in the same order
+    std::shared_ptr<arena>          storage;    // the arena the histories live in
+    unsigned int                    end_time;   // clock value when the run stopped
+    memory_stats                    memory;     // allocation and fragmentation counters
+    unsigned long long              events;     // events taken off the event queue
+    std::vector<cpu_stats>          cpus;       // one entry per simulated CPU
+};
+
+//Everything a run changes as it goes, apart from the policies' ready queues
+struct simulation_state {
+    process_table                       job_list;
+    std::unique_ptr<memory_manager>     memory;
+    admission_queue                     admission;
+    std::vector<cpu_core>               cores;
+    event_queue                         events;     // pending arrivals, I/O completions and the end of every running CPU burst
+    unsigned int                        current_time = 0;
+    unsigned long long                  events_processed = 0;
+
+    explicit simulation_state(const std::vector<PCB> &list_processes = {}, std::shared_ptr<arena> storage = nullptr)
+        : job_list(list_processes, std::move(storage)) {}
+};
+
+//Gives every CPU its policy: the one passed in for the first, clones for the others
+inline void bind_policies(std::vector<cpu_core> &cores, scheduler_policy &policy, process_table &table) {
+    for(cpu_core &core : cores) {
+        if(&core == &cores[0]) {
+            core.policy = &policy;
+        } else {
+            core.owned = policy.clone();
+            core.policy = core.owned.get();
+        }
+        core.policy->reset(table);
+    }
+}
+
+//-------------------------------------------------CHECKPOINTS------------------------------------------
+//A checkpoint holds the whole engine state at the top of a loop iteration: the
+//process table, memory, admission and event queues, the CPUs, the clock and every
+//CPU's ready queue. The simulator draws no random numbers, so that is all of it.
+//Overhead costs and policy settings are not stored, so a resumed run can try other
+//ones; the memory settings and the CPU count are, since the state depends on them.
+
+const uint32_t CHECKPOINT_MAGIC = 0x4b434953;      // "SICK" on little-endian machines
+const uint32_t CHECKPOINT_VERSION = 3;
+
+//Writes the state to path; returns false if the file could not be written
+inline bool save_checkpoint(const std::string &path, const simulation_state &state,
+                            const simulation_config &config) {
+    std::ofstream out(path, std::ios::binary);
+    if(!out) {
+        return false;
+    }
+
+    write_value(out, CHECKPOINT_MAGIC);
+    write_value(out, CHECKPOINT_VERSION);
+    write_value(out, config.memory_allocator);
+    write_vector(out, config.memory_partitions);
+    write_value(out, config.memory_size);
+    write_value<uint32_t>(out, state.cores.size());
+    write_value(out, state.current_time);
+    write_value(out, state.events_processed);
+
+    write_vector(out, state.job_list.processes());
+    for(const process_history &history : state.job_list.history) {
+        write_vector(out, history.ioStartTimes.to_vector());
+    }
+    state.memory->save(out);
+    write_vector(out, std::vector<int>(state.admission.waiting.begin(), state.admission.waiting.end()));
+    write_vector(out, state.admission.arrived);
+    write_value(out, state.admission.memory_freed);
+    state.events.save(out);
+
+    write_string(out, state.cores[0].policy->name());
+    for(const cpu_core &core : state.cores) {
+        write_value(out, core.running);
+        write_value(out, core.last_process);
+        write_value(out, core.burst);
+        write_value(out, core.busy_until);
+        write_value(out, core.stats);
+        write_vector(out, core.policy->queued());
+
+        std::ostringstream policy_state;
+        core.policy->save_state(policy_state);
+        write_string(out, policy_state.str());
+    }
+    return static_cast<bool>(out.flush());
+}
+
+//Reads a checkpoint back into state and hands every CPU's ready queue to policy (and
+//its clones). The memory settings and CPU count in config are replaced by the saved
+//ones. If the checkpoint was taken under another policy, the queued processes are
+//handed over in their saved order and the PCB priority fields start from scratch.
+inline bool load_checkpoint(const std::string &path, scheduler_policy &policy,
+                            simulation_state &state, simulation_config &config) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0, version = 0, cpus = 0;
+    if(!in) {
+        std::cerr << "Error: unable to open checkpoint " << path << std::endl;
+        return false;
+    }
+    if(!read_value(in, magic) || !read_value(in, version) ||
+       magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION) {
+        std::cerr << "Error: " << path << " is not a checkpoint" << std::endl;
+        return false;
+    }
+
+    auto corrupt = [&path]() {
+        std::cerr << "Error: checkpoint " << path << " is truncated or corrupt" << std::endl;
+        return false;
+    };
+
+    std::vector<PCB> processes;
+    if(!read_value(in, config.memory_allocator) || !read_vector(in, config.memory_partitions) ||
+       !read_value(in, config.memory_size) || !read_value(in, cpus) || cpus == 0 || cpus > MAX_CPUS ||
+       !read_value(in, state.current_time) || !read_value(in, state.events_processed) ||
+       !read_vector(in, processes, INT32_MAX) || config.memory_allocator > BUDDY) {
+        return corrupt();
+    }
+    config.cpus = cpus;
+
+    for(const PCB &process : processes) {
+        if(process.state < NEW || process.state > NOT_ASSIGNED ||
+           process.cpu < 0 || process.cpu >= static_cast<int>(cpus)) {
+            return corrupt();
+        }
+    }
+    state.job_list = process_table(processes, state.job_list.storage);
+    for(process_history &history : state.job_list.history) {
+        std::vector<int> io_starts;
+        if(!read_vector(in, io_starts)) {
+            return corrupt();
+        }
+        for(int time : io_starts) {
+            history.ioStartTimes.push_back(*state.job_list.storage, time);
+        }
+    }
+    const int handles = state.job_list.size();
+    auto valid = [handles](int handle) { return handle >= 0 && handle < handles; };
+
+    state.memory = make_memory_manager(config.memory_allocator, config.memory_partitions, config.memory_size);
+    std::vector<int> waiting;
+    if(!state.memory->load(in) || !read_vector(in, waiting) || !read_vector(in, state.admission.arrived) ||
+       !read_value(in, state.admission.memory_freed) || !state.events.load(in, handles) ||
+       !std::all_of(waiting.begin(), waiting.end(), valid) ||
+       !std::all_of(state.admission.arrived.begin(), state.admission.arrived.end(), valid)) {
+        return corrupt();
+    }
+    state.admission.waiting.insert(waiting.begin(), waiting.end());
+
+    std::string saved_policy;
+    if(!read_string(in, saved_policy)) {
+        return corrupt();
+    }
+    std::vector<std::pair<unsigned int, unsigned int>> priorities;
+    for(process_table::state_line &line : state.job_list.lines) {
+        process_state &process = line.state;
+        priorities.push_back({process.priority, process.priority_stamp});
+        process.priority = process.priority_stamp = 0;
+    }
+
+    state.cores = std::vector<cpu_core>(cpus);
+    bind_policies(state.cores, policy, state.job_list);
+    bool same_policy = saved_policy == policy.name();
+    if(same_policy) {
+        for(int handle = 0; handle < handles; handle++) {
+            state.job_list[handle].priority = priorities[handle].first;
+            state.job_list[handle].priority_stamp = priorities[handle].second;
+        }
+    }
+
+    for(cpu_core &core : state.cores) {
+        std::vector<int> queued;
+        std::string policy_state;
+        if(!read_value(in, core.running) || !read_value(in, core.last_process) || !read_value(in, core.burst) ||
+           !read_value(in, core.busy_until) || !read_value(in, core.stats) || !read_vector(in, queued) ||
+           !read_string(in, policy_state) || (core.running != NO_PROCESS && !valid(core.running)) ||
+           !std::all_of(queued.begin(), queued.end(), valid)) {
+            return corrupt();
+        }
+        std::istringstream saved_state(policy_state);
+        if(same_policy && !core.policy->load_state(saved_state)) {
+            return corrupt();
+        }
+        for(int handle : queued) {
+            core.policy->add_ready(handle);
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------THE RUN LOOP-----------------------------------------
+
+//Runs a simulation from the given state until every process has terminated (or
+//nothing can change any more), writing the execution table to log
+inline simulation_result simulate(simulation_state &state, execution_log &log, const simulation_config &config) {
+
+    process_table &job_list = state.job_list;
+    memory_manager &memory = *state.memory;
+    admission_queue &admission = state.admission;
+    std::vector<cpu_core> &cores = state.cores;
+    event_queue &events = state.events;
+    unsigned int &current_time = state.current_time;
+    const int cpus = static_cast<int>(cores.size());
+    bool checkpoint_pending = !config.checkpoint_path.empty();
+
+    log.header(cpus > 1);
+
+    while(!all_process_terminated(job_list)) {
+
+        if(checkpoint_pending && current_time >= config.checkpoint_time) {
+            checkpoint_pending = false;
+            if(!save_checkpoint(config.checkpoint_path, state, config)) {
+                std::cerr << "Error: could not write checkpoint " << config.checkpoint_path << std::endl;
+            }
+        }
+
+        for(cpu_core &core : cores) {
+            core.policy->on_clock(current_time);
+        }
+
+        // ---- 1) move newly-arrived jobs into READY ----
+        admit_arrivals(job_list, memory, admission, cores, current_time, log);
+
+        // ---- 2) let the policies preempt the running processes ----
+        for(cpu_core &core : cores) {
+            if(core.running != NO_PROCESS && core.policy->should_preempt(core.running)) {
+                core.stats.busy_time += charge_burst(job_list[core.running], current_time);
+                deschedule(job_list, core.running, current_time, log);
+                core.policy->on_preempt(core.running);
+                idle_CPU(core.running);
+                core.burst.seq = 0;
+            }
+        }
+
+        // ---- 3) every idle CPU picks its next process; the ones with an empty queue
+        //         then steal, so a process is never taken from a CPU about to run it ----
+        for(int pass = 0; pass < (cpus > 1 ? 2 : 1); pass++) {
+            for(int cpu = 0; cpu < cpus; cpu++) {
+                cpu_core &core = cores[cpu];
+                if(core.running == NO_PROCESS) {
+                    int next = pass == 0 ? core.policy->select_next() : steal_process(cores, cpu);
+                    if(next != NO_PROCESS) {
+                        dispatch(job_list, core, cpu, next, events, current_time, config.costs, log);
+                    }
+                }
+            }
+        }
+
+        // ---- 4) jump straight to the next event ----
+        if(events.empty()) {
+            break;                  // nothing can change any more (job too big for memory)
+        }
+
+        current_time = events.next_time();
+        while(!events.empty() && events.next_time() == current_time) {
+            sim_event event = events.pop();
+            state.events_processed++;
+            if(event.type == ARRIVAL) {
+                admission.arrived.push_back(event.process);     // admitted at the top of the loop
+                continue;
+            }
+            int cpu = job_list[event.process].cpu;
+            if(event.type == IO_DONE) {
+                if(config.costs.interrupt != 0) {
+                    handle_interrupt(job_list, cores[cpu], events, current_time, config.costs.interrupt);
+                }
+                finish_io(job_list, event.process, *cores[cpu].policy, current_time, log);
+                continue;
+            }
+            cpu_core &core = cores[cpu];
+            if(event.seq != core.burst.seq) {
+                continue;           // stale burst, its process was preempted
+            }
+
+            int running = core.running;
+            core.stats.busy_time += charge_burst(job_list[running], current_time);
+
+            if(event.type == COMPLETION) {
+                log.status(current_time, job_list[running].PID, RUNNING, TERMINATED, cpu);
+                terminate_process(job_list, running, memory, current_time);  // sets TERMINATED + frees mem
+                admission.memory_freed = true;
+            }
+            else if(event.type == IO_REQUEST) {
+                start_io(job_list, running, events, current_time, log);
+                core.policy->on_block(running);
+            }
+            else {
+                deschedule(job_list, running, current_time, log);
+                core.policy->on_quantum_expiry(running);
+            }
+            idle_CPU(core.running);
+        }
+    }
+
+    log.footer();
+    if(checkpoint_pending) {
+        std::cerr << "Warning: the run ended at " << current_time << " ms, no checkpoint written to "
+                  << config.checkpoint_path << std::endl;
+    }
+
+    std::vector<cpu_stats> cpu_usage;
+    for(const cpu_core &core : cores) {
+        // a CPU is idle, running a process or paying overhead, never two at once; only
+        // an interrupt still being handled on an idle CPU can outlast the run
+        assert(core.stats.busy_time + core.stats.overhead() <= std::max(current_time, core.busy_until));
+        cpu_usage.push_back(core.stats);
+    }
+    return {job_list.processes(), std::move(job_list.history), job_list.storage, current_time,
+            memory.stats(), state.events_processed, std::move(cpu_usage)};
+}
+
+//Runs one simulation of the given processes under the given policy, writing the
+//execution table to log. All state is local to the call, so simulations with
+//separate policy objects and logs can run in parallel. With more than one CPU the
+//policy runs the first CPU's ready queue and clones of it run the others.
+//The histories are kept in storage if one is given (a caller running many
+//simulations can reset and reuse one arena), otherwise in a new arena.
+inline simulation_result run_simulation(scheduler_policy &policy, std::vector<PCB> list_processes,
+                                        execution_log &log, const simulation_config &config = {},
+                                        std::shared_ptr<arena> storage = nullptr) {
+    simulation_state state(std::move(list_processes), std::move(storage));
+    state.memory = make_memory_manager(config.memory_allocator, config.memory_partitions, config.memory_size);
+    state.cores = std::vector<cpu_core>(std::clamp(config.cpus, 1u, MAX_CPUS));
+    bind_policies(state.cores, policy, state.job_list);
+    schedule_arrivals(state.events, state.job_list);
+
+    return simulate(state, log, config);
+}
+
+//Continues a run saved by a checkpoint under the given policy, which need not be the
+//one it started with. Costs and policy settings come from config, its memory settings
+//and CPU count from the checkpoint. Returns false if the file can't be used.
+inline bool resume_simulation(scheduler_policy &policy, const std::string &path, execution_log &log,
+                              simulation_config &config, simulation_result &result) {
+    simulation_state state;
+    if(!load_checkpoint(path, policy, state, config)) {
+        return false;
+    }
+    result = simulate(state, log, config);
+    return true;
+}
+
+#endif
\ No newline at end of file
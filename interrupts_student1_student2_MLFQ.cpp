@@ -0,0 +1,148 @@
+/**
+ * Multi-Level Feedback Queue scheduler for SYSC4001 A3 P1
+ * Levels and their quanta come from policy_config (10/20/40 ms by default).
+ */
+
+#include "interrupts_student1_student2.hpp"
+
+// ------------------ MLFQ policy: FIFO per level, highest level first ------------------
+// A new process starts at the top level. Using up a whole slice moves it down a
+// level, blocking for I/O moves it up one, and every boost_interval ms everyone
+// goes back to the top so CPU-bound processes can't starve. A process's level is
+// kept in its PCB (priority), so it follows the process from CPU to CPU.
+class MLFQ_scheduler : public scheduler_policy {
+public:
+    explicit MLFQ_scheduler(const policy_config &config)
+        : settings(config), levels(std::max<size_t>(1, config.level_quanta.size())) {
+        if (settings.level_quanta.empty()) {
+            settings.level_quanta.push_back(settings.quantum);
+        }
+    }
+
+    std::string name() const override { return "MLFQ"; }
+
+    std::unique_ptr<scheduler_policy> clone() const override {
+        return std::make_unique<MLFQ_scheduler>(settings);
+    }
+
+    void reset(process_table &table) override {
+        job_list = &table;
+        for (auto &level : levels) {
+            level.clear();
+        }
+        ready_processes = 0;
+        last_boost = 0;
+        boosts = 0;
+    }
+
+    void on_clock(unsigned int current_time) override {
+        if (settings.boost_interval != 0 && current_time - last_boost >= settings.boost_interval) {
+            boost(current_time);
+        }
+    }
+
+    void add_ready(int handle) override {
+        levels[level_of(handle)].push_back(handle);
+        ready_processes++;
+    }
+
+    void on_arrival(int handle) override {
+        set_level(handle, 0);
+        add_ready(handle);
+    }
+
+    // used a whole slice: CPU-bound, move down
+    void on_quantum_expiry(int handle) override {
+        set_level(handle, std::min<unsigned int>(level_of(handle) + 1, levels.size() - 1));
+        add_ready(handle);
+    }
+
+    // gave up the CPU for I/O: interactive, move up
+    void on_block(int handle) override {
+        unsigned int level = level_of(handle);
+        set_level(handle, level > 0 ? level - 1 : 0);
+    }
+
+    int select_next() override {
+        for (auto &level : levels) {
+            if (!level.empty()) {
+                int next = level.front();
+                level.pop_front();
+                ready_processes--;
+                return next;
+            }
+        }
+        return NO_PROCESS;
+    }
+
+    size_t ready_count() const override { return ready_processes; }
+
+    // top level first, each level in FIFO order
+    std::vector<int> queued() const override {
+        std::vector<int> handles;
+        for (const auto &level : levels) {
+            handles.insert(handles.end(), level.begin(), level.end());
+        }
+        return handles;
+    }
+
+    // the boost counter has to come back too, the levels in the PCBs are stamped with it
+    void save_state(std::ostream &out) const override {
+        write_value(out, last_boost);
+        write_value(out, boosts);
+    }
+
+    bool load_state(std::istream &in) override {
+        return read_value(in, last_boost) && read_value(in, boosts);
+    }
+
+    // preempt when a process on a higher level is ready
+    bool should_preempt(int running) override {
+        unsigned int level = level_of(running);
+        for (unsigned int higher = 0; higher < level; higher++) {
+            if (!levels[higher].empty()) return true;
+        }
+        return false;
+    }
+
+    unsigned int quantum(int handle) override {
+        return std::max(1u, settings.level_quanta[level_of(handle)]);
+    }
+
+private:
+    // a level set before the last boost no longer counts: the boost moved it to the top
+    unsigned int level_of(int handle) const {
+        const process_state &process = (*job_list)[handle];
+        if (process.priority_stamp != boosts) return 0;
+        return std::min<unsigned int>(process.priority, levels.size() - 1);
+    }
+
+    void set_level(int handle, unsigned int level) {
+        (*job_list)[handle].priority = level;
+        (*job_list)[handle].priority_stamp = boosts;
+    }
+
+    // moves every queued process to the top level, keeping their order level by level.
+    // No PCB is touched: bumping the stamp puts every process at level 0 in level_of().
+    void boost(unsigned int current_time) {
+        last_boost = current_time;
+        boosts++;
+        for (size_t level = 1; level < levels.size(); level++) {
+            for (int handle : levels[level]) {
+                levels[0].push_back(handle);
+            }
+            levels[level].clear();
+        }
+    }
+
+    policy_config settings;
+    process_table *job_list = nullptr;
+    std::vector<std::deque<int>> levels;
+    size_t ready_processes = 0;
+    unsigned int last_boost = 0;    // time of the last boost
+    unsigned int boosts = 0;        // boosts so far; stamps the levels set since
+};
+
+std::unique_ptr<scheduler_policy> make_MLFQ_scheduler(const policy_config &settings) {
+    return std::make_unique<MLFQ_scheduler>(settings);
+}
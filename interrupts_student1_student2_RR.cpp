@@ -1,142 +1,65 @@
 /**
- * Round Robin scheduler (100 ms quantum)
+ * Round Robin scheduler (100 ms quantum by default, see policy_config)
  */
 
 #include "interrupts_student1_student2.hpp"
 
-// ------------------ main simulation ------------------
-std::tuple<std::string /* add std::string for bonus mark if needed */>
-run_simulation(std::vector<PCB> list_processes) {
+// ------------------ RR policy: FIFO ready queue, time slices from policy_config ------------------
+class RR_scheduler : public scheduler_policy {
+public:
+    explicit RR_scheduler(const policy_config &settings) : slicer(settings) {}
 
-    std::vector<PCB> ready_queue;   // ready queue
-    std::vector<PCB> job_list = list_processes;
+    std::string name() const override { return "RR"; }
 
-    unsigned int current_time = 0;
-    PCB running;
-    idle_CPU(running);
-
-    unsigned int quantum_used = 0;      // how much of current 100 ms slice has been used
-
-    std::string execution_status;
-    execution_status = print_exec_header();
-
-    while (!all_process_terminated(job_list)) {
-
-        // ---- 1) move newly-arrived jobs into READY ----
-        for (auto &process : job_list) {
-            if (process.state == NOT_ASSIGNED &&
-                process.arrival_time <= current_time) {
-
-                if (assign_memory(process)) {
-                    states old_state = NEW;
-                    process.state = READY;
-                    ready_queue.push_back(process);
-                    sync_queue(job_list, process);
-
-                    execution_status +=
-                        print_exec_status(current_time,
-                                          process.PID,
-                                          old_state,
-                                          READY);
-                }
-            }
-        }
-
-        // ---- 2) if CPU idle, pick next process in RR order (FIFO) ----
-        if (running.state != RUNNING) {
-            if (!ready_queue.empty()) {
-                running = ready_queue.front();
-                ready_queue.erase(ready_queue.begin());
-
-                running.state = RUNNING;
-                if (running.start_time == -1)
-                    running.start_time = current_time;
-
-                sync_queue(job_list, running);
-                quantum_used = 0;
-
-                execution_status +=
-                    print_exec_status(current_time,
-                                      running.PID,
-                                      READY,
-                                      RUNNING);
-            }
-        }
-
-        // ---- 3) advance CPU one ms ----
-        if (running.state == RUNNING) {
-            // execute 1 ms of CPU time
-            if (running.remaining_time > 0)
-                running.remaining_time--;
-
-            quantum_used++;
-            sync_queue(job_list, running);
-
-            current_time++;
-
-            // finished?
-            if (running.remaining_time == 0) {
-                execution_status +=
-                    print_exec_status(current_time,
-                                      running.PID,
-                                      RUNNING,
-                                      TERMINATED);
+    std::unique_ptr<scheduler_policy> clone() const override {
+        return std::make_unique<RR_scheduler>(slicer.settings());
+    }
 
-                terminate_process(running, job_list); // set TERMINATED + free mem
-                idle_CPU(running);                    // CPU becomes idle
-            }
-            // time slice over?
-            else if (quantum_used >= 100) {
-                execution_status +=
-                    print_exec_status(current_time,
-                                      running.PID,
-                                      RUNNING,
-                                      READY);
+    void reset(process_table &table) override {
+        job_list = &table;
+        ready_queue.clear();
+        slicer.reset();
+    }
 
-                running.state = READY;
-                sync_queue(job_list, running);
-                ready_queue.push_back(running);       // back of RR queue
-                idle_CPU(running);
-            }
-        } else {
-            // CPU idle, just advance time until something arrives
-            current_time++;
-        }
+    // back of RR queue
+    void add_ready(int handle) override {
+        ready_queue.push_back(handle);
     }
 
-    execution_status += print_exec_footer();
-    return std::make_tuple(execution_status);
-}
+    int select_next() override {
+        if (ready_queue.empty()) return NO_PROCESS;
+        int next = ready_queue.front();
+        ready_queue.pop_front();
+        return next;
+    }
 
-// ------------------ main ------------------
-int main(int argc, char **argv) {
+    size_t ready_count() const override { return ready_queue.size(); }
 
-    if (argc != 2) {
-        std::cout << "ERROR!\nExpected 1 argument, received " << argc - 1 << std::endl;
-        std::cout << "To run the program, do: ./RR.exe <your_input_file.txt>" << std::endl;
-        return -1;
+    std::vector<int> queued() const override {
+        return std::vector<int>(ready_queue.begin(), ready_queue.end());
     }
 
-    auto file_name = argv[1];
-    std::ifstream input_file(file_name);
+    void save_state(std::ostream &out) const override { slicer.save(out); }
+    bool load_state(std::istream &in) override { return slicer.load(in); }
 
-    if (!input_file.is_open()) {
-        std::cerr << "Error: Unable to open file: " << file_name << std::endl;
-        return -1;
+    // every burst that ended early or ran out its slice feeds the adaptive quantum
+    void on_quantum_expiry(int handle) override {
+        slicer.observe((*job_list)[handle].last_burst);
+        add_ready(handle);
     }
 
-    std::string line;
-    std::vector<PCB> list_process;
-    while (std::getline(input_file, line)) {
-        auto input_tokens = split_delim(line, ", ");
-        auto new_process  = add_process(input_tokens);
-        list_process.push_back(new_process);
+    void on_block(int handle) override {
+        slicer.observe((*job_list)[handle].last_burst);
     }
-    input_file.close();
 
-    auto [exec] = run_simulation(list_process);
+    unsigned int quantum(int) override { return slicer.quantum(ready_queue.size()); }
 
-    write_output(exec, "output_files/RR_execution.txt.txt");
+private:
+    const process_table *job_list = nullptr;
+    std::deque<int> ready_queue;
+    time_slicer slicer;
+};
 
-    return 0;
+std::unique_ptr<scheduler_policy> make_RR_scheduler(const policy_config &settings) {
+    return std::make_unique<RR_scheduler>(settings);
 }
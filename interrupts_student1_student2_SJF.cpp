@@ -0,0 +1,89 @@
+/**
+ * Shortest Job First (non-preemptive) and Shortest Remaining Time First
+ * (preemptive) schedulers for SYSC4001 A3 P1
+ */
+
+#include "interrupts_student1_student2.hpp"
+
+// ------------------ SJF / SRTF policies: shortest remaining (or predicted) time first ------------------
+// By default a process is keyed on its true remaining CPU time. With predict_bursts
+// the policy pretends not to know it and keys on a prediction of the next CPU burst
+// instead, kept in the PCB's priority field and updated by exponential averaging
+// every time the process blocks: next = w * last_burst + (1 - w) * previous.
+class SJF_scheduler : public scheduler_policy {
+public:
+    SJF_scheduler(const policy_config &config, bool preemptive)
+        : settings(config), preemptive(preemptive) {}
+
+    std::string name() const override { return preemptive ? "SRTF" : "SJF"; }
+
+    std::unique_ptr<scheduler_policy> clone() const override {
+        return std::make_unique<SJF_scheduler>(settings, preemptive);
+    }
+
+    void reset(process_table &table) override {
+        job_list = &table;
+        ready_queue.clear();
+        now = 0;
+        if (settings.predict_bursts) {
+            for (int handle = 0; handle < table.size(); handle++) {
+                table[handle].priority = settings.initial_prediction;
+            }
+        }
+    }
+
+    void on_clock(unsigned int current_time) override { now = current_time; }
+
+    void add_ready(int handle) override {
+        ready_queue.push(handle, time_left(handle));
+    }
+
+    // a finished CPU burst updates the prediction
+    void on_block(int handle) override {
+        if (settings.predict_bursts) {
+            process_state &process = (*job_list)[handle];
+            double prediction = settings.prediction_weight * process.last_burst
+                              + (1.0 - settings.prediction_weight) * process.priority;
+            process.priority = static_cast<unsigned int>(prediction + 0.5);
+        }
+    }
+
+    int select_next() override {
+        if (ready_queue.empty()) return NO_PROCESS;
+        return ready_queue.pop();
+    }
+
+    size_t ready_count() const override { return ready_queue.size(); }
+
+    std::vector<int> queued() const override { return ready_queue.in_order(); }
+
+    // SRTF: preempt when a ready process needs less time than the running one has left
+    bool should_preempt(int running) override {
+        if (!preemptive || ready_queue.empty()) return false;
+
+        const process_state &process = (*job_list)[running];
+        long long used = now > process.burst_start ? now - process.burst_start : 0;
+        return ready_queue.top_key() < std::max(0LL, time_left(running) - used);
+    }
+
+private:
+    // key of a process: remaining CPU time, or the predicted length of its next burst
+    long long time_left(int handle) const {
+        const process_state &process = (*job_list)[handle];
+        return settings.predict_bursts ? process.priority : process.remaining_time;
+    }
+
+    policy_config settings;
+    bool preemptive;
+    process_table *job_list = nullptr;
+    priority_ready_queue ready_queue;
+    unsigned int now = 0;
+};
+
+std::unique_ptr<scheduler_policy> make_SJF_scheduler(const policy_config &settings) {
+    return std::make_unique<SJF_scheduler>(settings, false);
+}
+
+std::unique_ptr<scheduler_policy> make_SRTF_scheduler(const policy_config &settings) {
+    return std::make_unique<SJF_scheduler>(settings, true);
+}
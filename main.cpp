@@ -1,201 +1,580 @@
 #include "interrupts_student1_student2.hpp"
+#include "workload_loader.hpp"
+#include "histogram.hpp"
 #include <numeric>     // for future use, if needed
 #include <sstream>
-
-// Simple helper: read a line and split by whitespace into tokens
-std::vector<std::string> split_whitespace(const std::string &line) {
-    std::vector<std::string> tokens;
-    std::stringstream ss(line);
-    std::string token;
-    while (ss >> token) {
-        tokens.push_back(token);
-    }
-    return tokens;
-}
+#include <map>
+#include <thread>
+#include <atomic>
 
 // -------------- Metrics support --------------
 
+// processes are split into this many priority bands by PID (EP_RR runs the
+// lowest PID first, so band 1 is the highest priority and band 4 the lowest)
+const int PRIORITY_BANDS = 4;
+
+// summary of one metric over a group of processes
+struct Distribution {
+    double avg;
+    double p50;
+    double p90;
+    double p99;
+    double p999;
+    double max;
+};
+
 struct Metrics {
+    std::string band;       // "all" or the priority band number
+    uint64_t completed;
     double throughput;
-    double avgWait;
-    double avgTurnaround;
-    double avgResponse;
+    Distribution wait;
+    Distribution turnaround;
+    Distribution response;
+    unsigned long long usefulCpu;   // CPU ms spent running processes (whole run only)
+    unsigned long long overhead;    // CPU ms spent on switches, interrupts, decisions, migrations
 };
 
-// compute average gap between consecutive I/O operations for ONE process
-double computeAvgResponseTimeForProcess(const PCB &p) {
-    const auto &v = p.ioStartTimes;
-    if (v.size() < 2) {
-        // no or only one I/O => response time not really defined, treat as 0
-        return 0.0;
+// response time = time from arrival until the process first got the CPU
+uint32_t computeResponseTimeForProcess(const PCB &p) {
+    return static_cast<uint32_t>(p.start_time) - p.arrival_time;
+}
+
+Distribution summarize(const log_histogram &h) {
+    return {h.mean(), static_cast<double>(h.percentile(50)), static_cast<double>(h.percentile(90)),
+            static_cast<double>(h.percentile(99)), static_cast<double>(h.percentile(99.9)),
+            static_cast<double>(h.max())};
+}
+
+// histograms of one group of processes; fixed size however many processes there are
+struct MetricHistograms {
+    log_histogram wait;
+    log_histogram turnaround;
+    log_histogram response;
+
+    void record(const PCB &p) {
+        wait.record(p.totalWaitTime);
+        turnaround.record(p.finishTime - p.arrival_time);
+        response.record(computeResponseTimeForProcess(p));
     }
 
-    double sumGaps = 0.0;
-    for (size_t i = 1; i < v.size(); ++i) {
-        sumGaps += (v[i] - v[i - 1]);   // time between two I/O operations
+    Metrics summary(const std::string &band, int simEndTime) const {
+        return {band, wait.count(), static_cast<double>(wait.count()) / simEndTime,
+                summarize(wait), summarize(turnaround), summarize(response), 0, 0};
     }
-    return sumGaps / static_cast<double>(v.size() - 1);
-}
+};
 
-// procs = all processes that finished
-Metrics computeMetrics(const std::vector<PCB> &procs, int simEndTime) {
-    Metrics m{};
+// procs = every process of a run; only the ones that finished are counted.
+// Returns the metrics of all processes followed by those of each priority band.
+std::vector<Metrics> computeMetrics(const std::vector<PCB> &procs, int simEndTime) {
+    std::vector<Metrics> m;
 
     if (procs.empty() || simEndTime <= 0) return m;
 
-    const int N = static_cast<int>(procs.size());
+    int lowestPID = procs[0].PID;
+    int highestPID = procs[0].PID;
+    for (const PCB &p : procs) {
+        lowestPID = std::min(lowestPID, p.PID);
+        highestPID = std::max(highestPID, p.PID);
+    }
+    const double pidRange = static_cast<double>(highestPID) - lowestPID + 1;
 
-    double totalWait  = 0.0;
-    double totalTurn  = 0.0;
-    double totalResp  = 0.0;
+    MetricHistograms all;
+    std::vector<MetricHistograms> bands(PRIORITY_BANDS);
 
     for (const PCB &p : procs) {
-        // change field names here if your PCB uses different ones
-        int arrival  = p.arrival_time;
-        int finish   = p.finishTime;
-        int waitTime = p.totalWaitTime;
+        if (p.state != TERMINATED) continue;   // never got into memory
 
-        double turnaround = static_cast<double>(finish - arrival);
-        double resp       = computeAvgResponseTimeForProcess(p);
-
-        totalWait += waitTime;
-        totalTurn += turnaround;
-        totalResp += resp;
+        int band = static_cast<int>((p.PID - lowestPID) * PRIORITY_BANDS / pidRange);
+        all.record(p);
+        bands[band].record(p);
     }
 
-    // throughput = completed / total time
-    m.throughput    = static_cast<double>(N) / static_cast<double>(simEndTime);
-    m.avgWait       = totalWait / static_cast<double>(N);
-    m.avgTurnaround = totalTurn / static_cast<double>(N);
-    m.avgResponse   = totalResp / static_cast<double>(N);
-
+    m.push_back(all.summary("all", simEndTime));
+    for (int band = 0; band < PRIORITY_BANDS; band++) {
+        m.push_back(bands[band].summary(std::to_string(band + 1), simEndTime));
+    }
     return m;
 }
 
-// nice CSV-style print so you can copy into Excel
+// column names for printMetricsCSV
+void printMetricsCSVHeader() {
+    std::cout << "scheduler,scenario,band,completed,throughput";
+    for (const char *metric : {"wait", "turnaround", "response"}) {
+        for (const char *stat : {"avg", "p50", "p90", "p99", "p999", "max"}) {
+            std::cout << "," << stat << "_" << metric;
+        }
+    }
+    std::cout << ",useful_cpu,overhead" << std::endl;
+}
+
+// nice CSV-style print so you can copy into Excel: one row for all processes,
+// then one per priority band
 void printMetricsCSV(const std::string &schedulerName,
                      const std::string &scenarioName,
-                     const Metrics &m)
+                     const std::vector<Metrics> &metrics)
 {
-    std::cout << schedulerName << ","
-              << scenarioName  << ","
-              << m.throughput  << ","
-              << m.avgWait     << ","
-              << m.avgTurnaround << ","
-              << m.avgResponse << std::endl;
+    for (const Metrics &m : metrics) {
+        std::cout << schedulerName << ","
+                  << scenarioName  << ","
+                  << m.band        << ","
+                  << m.completed   << ","
+                  << m.throughput;
+        for (const Distribution *d : {&m.wait, &m.turnaround, &m.response}) {
+            std::cout << "," << d->avg << "," << d->p50 << "," << d->p90
+                      << "," << d->p99 << "," << d->p999 << "," << d->max;
+        }
+        if (m.band == "all") {
+            std::cout << "," << m.usefulCpu << "," << m.overhead;
+        } else {
+            std::cout << ",,";     // CPU time isn't split by band
+        }
+        std::cout << std::endl;
+    }
 }
 
-// -------------- main simulation --------------
+// metrics of one finished run
+std::vector<Metrics> simulationMetrics(const simulation_result &result) {
+    std::vector<Metrics> m = computeMetrics(result.processes, static_cast<int>(result.end_time));
+    if (!m.empty()) {
+        for (const cpu_stats &cpu : result.cpus) {
+            m[0].usefulCpu += cpu.busy_time;
+            m[0].overhead += cpu.overhead();
+        }
+    }
+    return m;
+}
 
-int main(int argc, char *argv[]) {
-    // ------------- choose input file -----------------
-    std::string input_path = "input_files/input.txt";   // default
-    if (argc > 1) {
-        input_path = argv[1];   // allow: ./bin/main input_files/whatever.txt
+// one line summary of how memory was used during a run
+void printMemoryStats(memory_mode mode, const memory_stats &stats) {
+    std::cout << "Memory (" << memory_mode_name(mode) << ", " << stats.total << " MB): "
+              << stats.allocations << " allocations, "
+              << stats.failures << " failed (" << stats.fragmentation_failures << " due to fragmentation), "
+              << "peak " << stats.peak_allocated << " MB in use, "
+              << "internal fragmentation " << 100.0 * stats.internal_fragmentation() << "%" << std::endl;
+}
+
+// how busy each simulated CPU was (multi-CPU runs) and how much of the CPU time
+// went to overhead rather than to the processes (when any cost is set)
+void printCpuStats(const simulation_result &result) {
+    cpu_stats total;
+    for (const cpu_stats &cpu : result.cpus) {
+        total.busy_time += cpu.busy_time;
+        total.migrations += cpu.migrations;
+        total.migration_time += cpu.migration_time;
+        total.context_switches += cpu.context_switches;
+        total.switch_time += cpu.switch_time;
+        total.interrupt_time += cpu.interrupt_time;
+        total.scheduler_time += cpu.scheduler_time;
     }
 
-    std::ifstream file(input_path);
-    if (!file.is_open()) {
-        std::cerr << "Error: could not open input file: " << input_path << std::endl;
-        return 1;
+    if (result.cpus.size() > 1) {
+        std::cout << "CPUs (" << result.cpus.size() << "): utilization";
+        for (size_t cpu = 0; cpu < result.cpus.size(); cpu++) {
+            double utilization = result.end_time ? 100.0 * result.cpus[cpu].busy_time / result.end_time : 0.0;
+            std::cout << " " << cpu << "=" << utilization << "%";
+        }
+        std::cout << ", " << total.migrations << " migrations (" << total.migration_time << " ms)" << std::endl;
     }
 
-    // ------------- load processes into PCB table -------------
-    std::vector<PCB> job_queue;
-    std::string line;
+    if (total.overhead() > 0) {
+        double share = 100.0 * total.overhead() / (total.overhead() + total.busy_time);
+        std::cout << "CPU time: " << total.busy_time << " ms useful, " << total.overhead() << " ms overhead ("
+                  << share << "%): " << total.context_switches << " context switches ("
+                  << total.switch_time << " ms), " << total.interrupt_time << " ms interrupts, "
+                  << total.scheduler_time << " ms scheduling, " << total.migration_time << " ms migrations"
+                  << std::endl;
+    }
+}
 
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
+// -------------- parallel sweep --------------
 
-        // tokens: PID mem arrival totalCPU ioFreq ioDur
-        std::vector<std::string> tokens = split_whitespace(line);
-        if (tokens.size() < 6) {
-            std::cerr << "Warning: skipping malformed line: " << line << std::endl;
-            continue;
-        }
+// one line of a sweep file: "<scheduler> <input_file> [key=value ...]"
+struct SweepJob {
+    std::string schedulerName;
+    std::string inputPath;
+    std::string scenarioName;   // input and parameters as written, e.g. "io.txt quantum=10"
+    simulation_config config;
+};
 
-        PCB p = add_process(tokens);
+// parses a whole number in [low, high] (times in ms, counts). Like std::stoi it throws
+// std::invalid_argument or std::out_of_range, and it also rejects trailing text and
+// negative numbers instead of letting them wrap around
+unsigned int parseCount(const std::string &text, unsigned int low = 0, unsigned int high = UINT_MAX) {
+    size_t used = 0;
+    long long value = std::stoll(text, &used);
+    if (used != text.size()) {
+        throw std::invalid_argument(text);
+    }
+    if (value < low || value > high) {
+        throw std::out_of_range(text);
+    }
+    return static_cast<unsigned int>(value);
+}
+
+// parses a fraction in [0, 1] (the burst prediction weight); throws like parseCount()
+double parseFraction(const std::string &text) {
+    size_t used = 0;
+    double value = std::stod(text, &used);
+    if (used != text.size()) {
+        throw std::invalid_argument(text);
+    }
+    if (!(0.0 <= value && value <= 1.0)) {
+        throw std::out_of_range(text);
+    }
+    return value;
+}
 
-        // make sure arrivalTime is set for metrics
-        // if add_process already sets it, you can remove this
-        p.arrivalTime = /* whatever your arrival value is, from tokens or p */ p.arrivalTime;
-        p.finishTime = 0;
-        p.totalWaitTime = 0;
-        // p.ioStartTimes starts empty
+// parses the MLFQ quanta, top level first: "10,20,40"
+bool parseLevelQuanta(const std::string &value, std::vector<unsigned int> &quanta) {
+    quanta.clear();
+    for (const std::string &quantum : split_delim(value, ",")) {
+        quanta.push_back(parseCount(quantum, 1));
+    }
+    return !quanta.empty();
+}
 
-        job_queue.push_back(p);
+// applies one "key=value" sweep parameter to a job's configuration; throws like
+// parseCount() on a malformed number
+bool applySweepParameter(const std::string &parameter, simulation_config &config) {
+    size_t eq = parameter.find('=');
+    if (eq == std::string::npos) {
+        return false;
     }
+    std::string key = parameter.substr(0, eq);
+    std::string value = parameter.substr(eq + 1);
 
-    file.close();
+    if (key == "memory") {
+        config.memory_partitions.clear();
+        return load_memory_partitions(value, config.memory_partitions);
+    }
+    if (key == "allocator") {
+        return parse_memory_mode(value, config.memory_allocator);
+    }
+    if (key == "memory_size") {
+        config.memory_size = parseCount(value);
+        return true;
+    }
+    if (key == "cpus") {
+        config.cpus = parseCount(value, 1, MAX_CPUS);
+        return true;
+    }
+    if (key == "migration_cost") {
+        config.costs.migration = parseCount(value);
+        return true;
+    }
+    if (key == "context_switch") {
+        config.costs.context_switch = parseCount(value);
+        return true;
+    }
+    if (key == "interrupt_cost") {
+        config.costs.interrupt = parseCount(value);
+        return true;
+    }
+    if (key == "scheduler_cost") {
+        config.costs.scheduler = parseCount(value);
+        return true;
+    }
+    if (key == "quantum") {
+        config.policy.quantum = parseCount(value, 1);
+        return true;
+    }
+    if (key == "quantum_mode") {
+        return parse_quantum_mode(value, config.policy.mode);
+    }
+    if (key == "min_quantum") {
+        config.policy.min_quantum = parseCount(value);
+        return true;
+    }
+    if (key == "max_quantum") {
+        config.policy.max_quantum = parseCount(value);
+        return true;
+    }
+    if (key == "target_latency") {
+        config.policy.target_latency = parseCount(value);
+        return true;
+    }
+    if (key == "level_quanta") {
+        return parseLevelQuanta(value, config.policy.level_quanta);
+    }
+    if (key == "boost_interval") {
+        config.policy.boost_interval = parseCount(value);
+        return true;
+    }
+    if (key == "predict_bursts") {
+        config.policy.predict_bursts = parseCount(value, 0, 1) != 0;
+        return true;
+    }
+    if (key == "prediction_weight") {
+        config.policy.prediction_weight = parseFraction(value);
+        return true;
+    }
+    if (key == "initial_prediction") {
+        config.policy.initial_prediction = parseCount(value);
+        return true;
+    }
+    return false;
+}
 
-    if (job_queue.empty()) {
-        std::cerr << "No valid processes were loaded from " << input_path << std::endl;
+// Runs every job of the sweep file on a pool of worker threads and prints its CSV
+// rows in the order the jobs are listed, with the job's parameters in the scenario.
+// Each simulation owns all of its state, so the workers share nothing but the
+// (read-only) loaded workloads.
+int runSweep(const std::string &sweep_path, unsigned int threads) {
+    std::ifstream file(sweep_path);
+    if (!file.is_open()) {
+        std::cerr << "Error: could not open sweep file: " << sweep_path << std::endl;
         return 1;
     }
 
-    std::cout << "Loaded " << job_queue.size() << " processes from "
-              << input_path << std::endl;
+    std::vector<SweepJob> jobs;
+    std::map<std::string, std::vector<PCB>> workloads;   // each input is loaded once
+    std::string line;
+    int line_number = 0;
 
-    // ------------- assign memory to each process -------------
-    for (auto &p : job_queue) {
-        bool ok = assign_memory(p);
-        if (!ok) {
-            std::cout << "PID " << p.PID << " could not be assigned a partition (not enough memory)"
+    while (std::getline(file, line)) {
+        line_number++;
+        std::vector<std::string> tokens = split_whitespace(line);
+        if (tokens.empty() || tokens[0][0] == '#') {
+            continue;
+        }
+        SweepJob job{tokens[0], tokens.size() > 1 ? tokens[1] : "", "", {}};
+        bool valid = tokens.size() >= 2 && make_scheduler(job.schedulerName);
+        try {
+            for (size_t t = 2; valid && t < tokens.size(); t++) {
+                valid = applySweepParameter(tokens[t], job.config);
+            }
+        } catch (const std::exception &) {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "Error: " << sweep_path << ":" << line_number
+                      << ": expected \"<EP|RR|EP_RR|MLFQ|SJF|SRTF> <input_file> [memory=<file>] [allocator=<mode>] [memory_size=<MB>]"
+                      << " [cpus=<n>] [migration_cost=<ms>] [context_switch=<ms>] [interrupt_cost=<ms>]"
+                      << " [scheduler_cost=<ms>] [quantum=<ms>] [quantum_mode=fixed|burst|queue]"
+                      << " [min_quantum=<ms>] [max_quantum=<ms>] [target_latency=<ms>]"
+                      << " [level_quanta=<ms>,<ms>,...] [boost_interval=<ms>] [predict_bursts=0|1]"
+                      << " [prediction_weight=<0..1>] [initial_prediction=<ms>]\""
                       << std::endl;
-        } else {
-            std::cout << "PID " << p.PID << " assigned to partition "
-                      << p.partition_number << std::endl;
+            return 1;
+        }
+        // jobs on one input differ only in their parameters, so they are part of the scenario;
+        // level_quanta lists have commas, hence the CSV quotes
+        job.scenarioName = job.inputPath;
+        for (size_t t = 2; t < tokens.size(); t++) {
+            job.scenarioName += " " + tokens[t];
+        }
+        if (job.scenarioName.find(',') != std::string::npos) {
+            job.scenarioName = "\"" + job.scenarioName + "\"";
+        }
+        if (!workloads.count(job.inputPath) && !load_workload(job.inputPath, workloads[job.inputPath])) {
+            return 1;
         }
+        jobs.push_back(job);
     }
 
-    // show current PCB table
-    std::cout << std::endl << "Current PCB table:" << std::endl;
-    std::cout << print_PCB(job_queue) << std::endl;
+    std::vector<std::vector<Metrics>> results(jobs.size());
+    std::atomic<size_t> next_job{0};
+
+    auto worker = [&]() {
+        // one arena per worker: the histories of a job are dropped in one go before the next
+        std::shared_ptr<arena> storage = std::make_shared<arena>();
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+            std::unique_ptr<scheduler_policy> scheduler = make_scheduler(jobs[i].schedulerName, jobs[i].config.policy);
+            execution_log log(LOG_DISCARD);     // a sweep only reports metrics
+            storage->reset();
+            simulation_result result = run_simulation(*scheduler, workloads.at(jobs[i].inputPath), log,
+                                                      jobs[i].config, storage);
+            results[i] = simulationMetrics(result);
+        }
+    };
 
-    // ------------- minimal execution log (your existing example) -------------
-    std::string exec_log;
-    exec_log += print_exec_header();
+    threads = std::max(1u, std::min<unsigned int>(threads, jobs.size()));
+    std::vector<std::thread> pool;
+    for (unsigned int t = 0; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    for (auto &thread : pool) {
+        thread.join();
+    }
 
-    unsigned int current_time = 0;
-    PCB &first = job_queue.front();
+    printMetricsCSVHeader();
+    for (size_t i = 0; i < jobs.size(); i++) {
+        printMetricsCSV(jobs[i].schedulerName, jobs[i].scenarioName, results[i]);
+    }
+    return 0;
+}
 
-    states old_state = NEW;
-    states new_state = READY;
+// -------------- main simulation --------------
 
-    first.state = new_state;
-    sync_queue(job_queue, first);
+int main(int argc, char *argv[]) {
+    // ------------- sweep mode -----------------
+    // usage: ./bin/main --sweep <sweep_file> [threads]   (default: one per core)
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        if (argc < 3) {
+            std::cerr << "To run a sweep, do: ./bin/main --sweep <sweep_file> [threads]" << std::endl;
+            return 1;
+        }
+        unsigned int threads = std::thread::hardware_concurrency();
+        if (argc > 3) {
+            try {
+                threads = parseCount(argv[3], 1);
+            } catch (const std::exception &) {
+                std::cerr << "Error: bad thread count: " << argv[3] << std::endl;
+                return 1;
+            }
+        }
+        return runSweep(argv[2], threads);
+    }
 
-    exec_log += print_exec_status(current_time, first.PID, old_state, new_state);
-    exec_log += print_exec_footer();
+    // ------------- choose input file, schedulers and options -----------------
+    // usage: ./bin/main <input_file> [EP|RR|EP_RR|MLFQ|SJF|SRTF ...] [--memory <partition_file>]
+    //        [--allocator fixed|first-fit|best-fit|worst-fit|buddy] [--memory-size <MB>]
+    //        [--cpus <1..4096>] [--migration-cost <ms>] [--context-switch <ms>] [--interrupt-cost <ms>]
+    //        [--scheduler-cost <ms>] [--quantum <ms>] [--quantum-mode fixed|burst|queue]
+    //        [--min-quantum <ms>] [--max-quantum <ms>] [--target-latency <ms>]
+    //        [--level-quanta <ms>,<ms>,...] [--boost-interval <ms>] [--predict-bursts]
+    //        [--prediction-weight <0..1>] [--initial-prediction <ms>] [--trace]
+    //        [--checkpoint <file> --checkpoint-at <ms>]
+    //        ./bin/main --resume <checkpoint_file> [schedulers and options as above]
+    //        (default: all schedulers, fixed partitions from the built-in table, one CPU,
+    //        free context switches/interrupts/decisions, fixed 100 ms quantum, text tables)
+    //        --trace writes binary traces (<scheduler>_execution.bin) instead of text tables;
+    //        ./bin/trace_to_text turns them back into tables
+    //        --checkpoint saves the whole simulation state once the clock reaches --checkpoint-at
+    //        (to <file>.<scheduler> when several schedulers run); --resume continues such a
+    //        state under every listed scheduler, with the costs and policy settings given
+    bool binary_trace = false;
+    std::string resume_path;
+    std::string input_path = "input_files/input.txt";   // default
+    std::vector<std::string> schedulers;
+    simulation_config config;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--memory" && i + 1 < argc) {
+                config.memory_partitions.clear();
+                if (!load_memory_partitions(argv[++i], config.memory_partitions)) {
+                    return 1;
+                }
+            } else if (arg == "--allocator" && i + 1 < argc) {
+                if (!parse_memory_mode(argv[++i], config.memory_allocator)) {
+                    std::cerr << "Error: unknown allocator " << argv[i]
+                              << " (expected fixed, first-fit, best-fit, worst-fit or buddy)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--memory-size" && i + 1 < argc) {
+                config.memory_size = parseCount(argv[++i]);
+            } else if (arg == "--cpus" && i + 1 < argc) {
+                config.cpus = parseCount(argv[++i], 1, MAX_CPUS);
+            } else if (arg == "--migration-cost" && i + 1 < argc) {
+                config.costs.migration = parseCount(argv[++i]);
+            } else if (arg == "--context-switch" && i + 1 < argc) {
+                config.costs.context_switch = parseCount(argv[++i]);
+            } else if (arg == "--interrupt-cost" && i + 1 < argc) {
+                config.costs.interrupt = parseCount(argv[++i]);
+            } else if (arg == "--scheduler-cost" && i + 1 < argc) {
+                config.costs.scheduler = parseCount(argv[++i]);
+            } else if (arg == "--quantum" && i + 1 < argc) {
+                config.policy.quantum = parseCount(argv[++i], 1);
+            } else if (arg == "--quantum-mode" && i + 1 < argc) {
+                if (!parse_quantum_mode(argv[++i], config.policy.mode)) {
+                    std::cerr << "Error: unknown quantum mode " << argv[i]
+                              << " (expected fixed, burst or queue)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--min-quantum" && i + 1 < argc) {
+                config.policy.min_quantum = parseCount(argv[++i]);
+            } else if (arg == "--max-quantum" && i + 1 < argc) {
+                config.policy.max_quantum = parseCount(argv[++i]);
+            } else if (arg == "--target-latency" && i + 1 < argc) {
+                config.policy.target_latency = parseCount(argv[++i]);
+            } else if (arg == "--level-quanta" && i + 1 < argc) {
+                if (!parseLevelQuanta(argv[++i], config.policy.level_quanta)) {
+                    std::cerr << "Error: --level-quanta expects quanta like 10,20,40" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--boost-interval" && i + 1 < argc) {
+                config.policy.boost_interval = parseCount(argv[++i]);
+            } else if (arg == "--predict-bursts") {
+                config.policy.predict_bursts = true;
+            } else if (arg == "--prediction-weight" && i + 1 < argc) {
+                config.policy.prediction_weight = parseFraction(argv[++i]);
+            } else if (arg == "--initial-prediction" && i + 1 < argc) {
+                config.policy.initial_prediction = parseCount(argv[++i]);
+            } else if (arg == "--trace") {
+                binary_trace = true;
+            } else if (arg == "--checkpoint" && i + 1 < argc) {
+                config.checkpoint_path = argv[++i];
+            } else if (arg == "--checkpoint-at" && i + 1 < argc) {
+                config.checkpoint_time = parseCount(argv[++i]);
+            } else if (arg == "--resume" && i + 1 < argc) {
+                resume_path = argv[++i];
+            } else if (i == 1) {
+                input_path = arg;   // allow: ./bin/main input_files/whatever.txt
+            } else {
+                schedulers.push_back(arg);
+            }
+        } catch (const std::exception &) {
+            // not a number, or out of range: negative, --cpus above MAX_CPUS, --quantum 0
+            std::cerr << "Error: bad value for " << arg << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
 
-    // write to output_files/execution.txt
-    write_output(exec_log, "output_files/execution.txt");
+    if (schedulers.empty()) {
+        schedulers = scheduler_names;
+    }
 
-    std::cout << "Simulation finished. Execution log written to "
-              << "output_files/execution.txt" << std::endl;
+    // ------------- load processes into PCB table (a resumed run has them in the checkpoint) -------------
+    std::vector<PCB> job_queue;
+    if (resume_path.empty()) {
+        if (!load_workload(input_path, job_queue)) {
+            return 1;
+        }
+        std::cout << "Loaded " << job_queue.size() << " processes from "
+                  << input_path << std::endl;
+    }
+    const std::string checkpointPath = config.checkpoint_path;
+    std::shared_ptr<arena> storage = std::make_shared<arena>();    // histories, reused run after run
+
+    // ------------- run every requested scheduler over the same workload -------------
+    printMetricsCSVHeader();
+    for (const std::string &schedulerName : schedulers) {
+        std::unique_ptr<scheduler_policy> scheduler = make_scheduler(schedulerName, config.policy);
+        if (!scheduler) {
+            std::cerr << "Error: unknown scheduler " << schedulerName
+                      << " (expected EP, RR, EP_RR, MLFQ, SJF or SRTF)" << std::endl;
+            return 1;
+        }
 
-    // ------------- metrics at end of simulation -------------
-    // for now, this example just uses current_time = 0 and treats all as finished
-    // when you have a real scheduler loop, set:
-    //   current_time = final clock value
-    //   set p.finishTime when each process actually completes
+        // stream the table to output_files/<scheduler>_execution.txt (or .bin) as the simulation runs
+        std::string output_path = "output_files/" + schedulerName + (binary_trace ? "_execution.bin" : "_execution.txt");
+        execution_log log(binary_trace ? LOG_TO_TRACE : LOG_TO_FILE, output_path);
 
-    int simEndTime = static_cast<int>(current_time);   // change when you have a real clock
-    for (auto &p : job_queue) {
-        if (p.finishTime == 0) {
-            p.finishTime = simEndTime;  // temporary, so code compiles and metrics are defined
+        if (!checkpointPath.empty() && schedulers.size() > 1) {
+            config.checkpoint_path = checkpointPath + "." + schedulerName;
         }
-    }
 
-    std::vector<PCB> finishedProcs = job_queue;
+        simulation_result result;
+        storage->reset();
+        if (resume_path.empty()) {
+            result = run_simulation(*scheduler, job_queue, log, config, storage);
+        } else if (!resume_simulation(*scheduler, resume_path, log, config, result)) {
+            return 1;
+        }
+        if (log.good()) {
+            std::cout << "Output generated in " << output_path << std::endl;
+        }
 
-    std::string schedulerName = "FCFS";          // change depending on which scheduler
-    std::string scenarioName  = input_path;      // input file as scenario name
+        // ------------- metrics at end of simulation -------------
+        std::string scenarioName = resume_path.empty() ? input_path : resume_path;     // input file as scenario name
 
-    Metrics m = computeMetrics(finishedProcs, simEndTime);
-    printMetricsCSV(schedulerName, scenarioName, m);
+        std::vector<Metrics> m = simulationMetrics(result);
+        printMetricsCSV(schedulerName, scenarioName, m);
+        printMemoryStats(config.memory_allocator, result.memory);
+        printCpuStats(result);
+    }
 
     return 0;
 }
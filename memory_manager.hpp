@@ -0,0 +1,550 @@
+/**
+ * @file memory_manager.hpp
+ * @brief partitioned main memory for the SYSC4001 A3 P1 simulator
+ *
+ */
+
+#ifndef MEMORY_MANAGER_HPP_
+#define MEMORY_MANAGER_HPP_
+
+#include<iostream>
+#include<fstream>
+#include<sstream>
+#include<string>
+#include<vector>
+#include<set>
+#include<map>
+#include<memory>
+#include<algorithm>
+#include<unordered_map>
+#include<climits>
+#include<iterator>
+#include "binary_io.hpp"
+
+struct memory_partition{
+    unsigned int    partition_number;
+    unsigned int    size;
+    int             occupied;
+};
+
+// fixed partition table every simulation starts from (sizes in MB)
+// inline variable (C++17) so it can appear in multiple TUs
+inline const std::vector<memory_partition> default_memory_partitions = {
+    {1, 40, -1},
+    {2, 25, -1},
+    {3, 15, -1},
+    {4, 10, -1},
+    {5, 8, -1},
+    {6, 2, -1}
+};
+
+//Reads a partition table, one "<partition_number> <size>" pair per line ('#' starts
+//a comment, commas between the numbers are allowed). Partition numbers must be
+//unique. Returns false on any error.
+inline bool load_memory_partitions(const std::string &path, std::vector<memory_partition> &partitions) {
+    std::ifstream file(path);
+    if(!file.is_open()) {
+        std::cerr << "Error: could not open partition file: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while(std::getline(file, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        for(auto &c : line) {
+            if(c == ',') c = ' ';
+        }
+
+        std::stringstream fields(line);
+        long long number, size;
+        if(!(fields >> number)) {
+            continue;       // blank or comment-only line
+        }
+        if(!(fields >> size) || number < 0 || size <= 0) {
+            std::cerr << "Error: " << path << ":" << line_number
+                      << ": expected \"<partition_number> <size>\"" << std::endl;
+            return false;
+        }
+        //the engine frees a partition by its number, so each number must name one partition
+        if(std::any_of(partitions.begin(), partitions.end(),
+                       [number](const memory_partition &partition) { return partition.partition_number == number; })) {
+            std::cerr << "Error: " << path << ":" << line_number
+                      << ": partition number " << number << " is used twice" << std::endl;
+            return false;
+        }
+        partitions.push_back({static_cast<unsigned int>(number), static_cast<unsigned int>(size), -1});
+    }
+
+    if(partitions.empty()) {
+        std::cerr << "Error: no partitions in " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//Allocation engines a simulation can use
+enum memory_mode {
+    FIXED_PARTITIONS,   // best fit over the partition table
+    FIRST_FIT,          // variable partitions carved out of one contiguous memory
+    BEST_FIT,
+    WORST_FIT,
+    BUDDY               // power-of-two blocks split and merged in buddy pairs
+};
+
+inline const char *memory_mode_name(memory_mode mode) {
+    const char *names[] = {"fixed", "first-fit", "best-fit", "worst-fit", "buddy"};
+    return names[mode];
+}
+
+inline bool parse_memory_mode(const std::string &name, memory_mode &mode) {
+    for(int m = FIXED_PARTITIONS; m <= BUDDY; m++) {
+        if(name == memory_mode_name(static_cast<memory_mode>(m))) {
+            mode = static_cast<memory_mode>(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+//Allocation and fragmentation counters, all sizes in MB
+struct memory_stats {
+    unsigned int        total = 0;              // memory managed
+    unsigned int        allocated = 0;          // handed out right now (whole partitions/blocks)
+    unsigned int        requested = 0;          // what the current owners asked for
+    unsigned int        peak_allocated = 0;
+
+    unsigned long long  allocations = 0;
+    unsigned long long  failures = 0;
+    unsigned long long  fragmentation_failures = 0;  // failed although enough memory was free in total
+    unsigned long long  granted_total = 0;      // summed over every allocation
+    unsigned long long  requested_total = 0;
+
+    //Share of all memory handed out that the owners never asked for
+    double internal_fragmentation() const {
+        return granted_total == 0 ? 0.0 : 1.0 - static_cast<double>(requested_total) / granted_total;
+    }
+};
+
+//Main memory owned by one simulation. allocate() returns a number identifying the
+//block (the partition number for fixed partitions, the start address in MB otherwise)
+//that release() later takes back. Every engine keeps memory_stats up to date.
+class memory_manager {
+public:
+    virtual ~memory_manager() = default;
+
+    //Gives PID a block of at least size MB; returns its number, or -1 if nothing fits
+    virtual int allocate(int PID, unsigned int size) = 0;
+
+    //Frees a block handed out by allocate(); returns false if it wasn't in use
+    virtual bool release(int number) = 0;
+
+    const memory_stats &stats() const { return usage; }
+
+    //Checkpoints: writes or reads back the whole allocation state, counters included.
+    //load() expects an engine built with the same settings as the one that saved.
+    void save(std::ostream &out) const {
+        write_value(out, usage);
+        save_blocks(out);
+    }
+
+    bool load(std::istream &in) {
+        return read_value(in, usage) && load_blocks(in);
+    }
+
+protected:
+    virtual void save_blocks(std::ostream &out) const = 0;
+    virtual bool load_blocks(std::istream &in) = 0;
+
+    void record_allocation(unsigned int requested, unsigned int granted) {
+        usage.allocated += granted;
+        usage.requested += requested;
+        usage.peak_allocated = std::max(usage.peak_allocated, usage.allocated);
+        usage.allocations++;
+        usage.granted_total += granted;
+        usage.requested_total += requested;
+    }
+
+    void record_release(unsigned int requested, unsigned int granted) {
+        usage.allocated -= granted;
+        usage.requested -= requested;
+    }
+
+    void record_failure(unsigned int requested) {
+        usage.failures++;
+        if(usage.total - usage.allocated >= requested) {
+            usage.fragmentation_failures++;
+        }
+    }
+
+    memory_stats usage;
+};
+
+//Fixed partitions. Allocation is best fit: the smallest free partition the process
+//fits in, the later one in the table on a tie (the order the original scan from the
+//end of the table produced). Free partitions are kept in a set ordered by size, so
+//allocate and release are O(log n) however many partitions there are.
+class fixed_partition_memory : public memory_manager {
+public:
+    explicit fixed_partition_memory(std::vector<memory_partition> partition_table)
+        : partitions(std::move(partition_table)), requested_of(partitions.size(), 0) {
+        for(int i = 0; i < static_cast<int>(partitions.size()); i++) {
+            index_of[partitions[i].partition_number] = i;
+            usage.total += partitions[i].size;
+            if(partitions[i].occupied == -1) {
+                free_partitions.insert({partitions[i].size, i});
+            }
+        }
+    }
+
+    int allocate(int PID, unsigned int size) override {
+        auto best = free_partitions.lower_bound({size, INT_MAX});
+        if(best == free_partitions.end()) {
+            record_failure(size);
+            return -1;
+        }
+
+        memory_partition &partition = partitions[best->index];
+        requested_of[best->index] = size;
+        free_partitions.erase(best);
+        partition.occupied = PID;
+        record_allocation(size, partition.size);
+        return partition.partition_number;
+    }
+
+    bool release(int partition_number) override {
+        auto found = index_of.find(partition_number);
+        if(found == index_of.end() || partitions[found->second].occupied == -1) {
+            return false;
+        }
+
+        memory_partition &partition = partitions[found->second];
+        partition.occupied = -1;
+        free_partitions.insert({partition.size, found->second});
+        record_release(requested_of[found->second], partition.size);
+        return true;
+    }
+
+    const std::vector<memory_partition> &partition_table() const { return partitions; }
+
+protected:
+    void save_blocks(std::ostream &out) const override {
+        std::vector<int> owners;
+        for(const auto &partition : partitions) {
+            owners.push_back(partition.occupied);
+        }
+        write_vector(out, owners);
+        write_vector(out, requested_of);
+    }
+
+    bool load_blocks(std::istream &in) override {
+        std::vector<int> owners;
+        if(!read_vector(in, owners) || !read_vector(in, requested_of) ||
+           owners.size() != partitions.size() || requested_of.size() != partitions.size()) {
+            return false;
+        }
+        free_partitions.clear();
+        for(int i = 0; i < static_cast<int>(partitions.size()); i++) {
+            partitions[i].occupied = owners[i];
+            if(owners[i] == -1) {
+                free_partitions.insert({partitions[i].size, i});
+            }
+        }
+        return true;
+    }
+
+private:
+    struct free_slot {
+        unsigned int    size;
+        int             index;      // position in partitions
+
+        //smallest size first, later partition first among equal sizes
+        bool operator<(const free_slot &other) const {
+            if(size != other.size) return size < other.size;
+            return index > other.index;
+        }
+    };
+
+    std::vector<memory_partition>   partitions;
+    std::vector<unsigned int>       requested_of;   // size asked for by each partition's owner
+    std::set<free_slot>             free_partitions;
+    std::unordered_map<int, int>    index_of;       // partition number -> position
+};
+
+//Variable partitions: each process gets exactly the size it asks for, carved from
+//the start of a hole in one contiguous memory; freed blocks merge with neighbouring
+//holes. Holes are indexed by address (first fit, merging) and by size (best and
+//worst fit in O(log n)).
+class variable_partition_memory : public memory_manager {
+public:
+    variable_partition_memory(unsigned int memory_size, memory_mode fit) : fit(fit) {
+        usage.total = memory_size;
+        add_hole(0, memory_size);
+    }
+
+    int allocate(int, unsigned int size) override {
+        unsigned int needed = std::max(size, 1u);
+
+        auto hole = holes.end();
+        if(fit == FIRST_FIT) {
+            for(hole = holes.begin(); hole != holes.end() && hole->second < needed; ++hole) {}
+        } else if(fit == BEST_FIT) {
+            auto best = holes_by_size.lower_bound({needed, 0});
+            if(best != holes_by_size.end()) hole = holes.find(best->second);
+        } else if(!holes_by_size.empty() && holes_by_size.rbegin()->first >= needed) {
+            hole = holes.find(holes_by_size.rbegin()->second);
+        }
+
+        if(hole == holes.end()) {
+            record_failure(size);
+            return -1;
+        }
+
+        unsigned int start = hole->first;
+        unsigned int hole_size = hole->second;
+        remove_hole(hole);
+        if(hole_size > needed) {
+            add_hole(start + needed, hole_size - needed);
+        }
+
+        blocks[start] = {needed, size};
+        record_allocation(size, needed);
+        return static_cast<int>(start);
+    }
+
+    bool release(int number) override {
+        auto block = blocks.find(static_cast<unsigned int>(number));
+        if(number < 0 || block == blocks.end()) {
+            return false;
+        }
+
+        unsigned int start = block->first;
+        unsigned int size = block->second.size;
+        record_release(block->second.requested, size);
+        blocks.erase(block);
+
+        //merge with the hole right after and the hole right before
+        auto next = holes.find(start + size);
+        if(next != holes.end()) {
+            size += next->second;
+            remove_hole(next);
+        }
+        auto after = holes.lower_bound(start);
+        if(after != holes.begin()) {
+            auto previous = std::prev(after);
+            if(previous->first + previous->second == start) {
+                start = previous->first;
+                size += previous->second;
+                remove_hole(previous);
+            }
+        }
+        add_hole(start, size);
+        return true;
+    }
+
+protected:
+    void save_blocks(std::ostream &out) const override {
+        std::vector<saved_range> saved_holes;
+        for(const auto &hole : holes) {
+            saved_holes.push_back({hole.first, {hole.second, 0}});
+        }
+        std::vector<saved_range> allocated;
+        for(const auto &block : blocks) {
+            allocated.push_back({block.first, block.second});
+        }
+        write_vector(out, saved_holes);
+        write_vector(out, allocated);
+    }
+
+    bool load_blocks(std::istream &in) override {
+        std::vector<saved_range> saved_holes;
+        std::vector<saved_range> allocated;
+        if(!read_vector(in, saved_holes) || !read_vector(in, allocated)) {
+            return false;
+        }
+        holes.clear();
+        holes_by_size.clear();
+        for(const auto &hole : saved_holes) {
+            add_hole(hole.start, hole.block.size);
+        }
+        blocks.clear();
+        for(const auto &block : allocated) {
+            blocks[block.start] = block.block;
+        }
+        return true;
+    }
+
+private:
+    struct block_info {
+        unsigned int    size;
+        unsigned int    requested;
+    };
+
+    struct saved_range {
+        unsigned int    start;
+        block_info      block;
+    };
+
+    void add_hole(unsigned int start, unsigned int size) {
+        holes[start] = size;
+        holes_by_size.insert({size, start});
+    }
+
+    void remove_hole(std::map<unsigned int, unsigned int>::iterator hole) {
+        holes_by_size.erase({hole->second, hole->first});
+        holes.erase(hole);
+    }
+
+    memory_mode                                         fit;
+    std::map<unsigned int, unsigned int>                holes;          // start -> size
+    std::set<std::pair<unsigned int, unsigned int>>     holes_by_size;  // (size, start)
+    std::unordered_map<unsigned int, block_info>        blocks;         // start -> allocated block
+};
+
+//Buddy system over one contiguous memory. Blocks are powers of two (1 MB and up);
+//a request takes the smallest free block it fits in, splitting larger ones in
+//halves, and a freed block merges with its buddy whenever the buddy is free too.
+//A memory size that isn't a power of two is covered by several top-level blocks.
+class buddy_memory : public memory_manager {
+public:
+    explicit buddy_memory(unsigned int memory_size) {
+        usage.total = memory_size;
+        unsigned int start = 0;
+        for(int order = 31; order >= 0; order--) {
+            if(memory_size & (1u << order)) {
+                free_blocks(order).insert(start);
+                start += 1u << order;
+            }
+        }
+    }
+
+    int allocate(int, unsigned int size) override {
+        int order = 0;
+        while((1ull << order) < std::max(size, 1u)) {
+            order++;
+        }
+
+        int available = order;
+        while(available < static_cast<int>(free_lists.size()) && free_lists[available].empty()) {
+            available++;
+        }
+        if(available >= static_cast<int>(free_lists.size())) {
+            record_failure(size);
+            return -1;
+        }
+
+        unsigned int start = *free_lists[available].begin();
+        free_lists[available].erase(free_lists[available].begin());
+        while(available > order) {
+            available--;
+            free_blocks(available).insert(start + (1u << available));   // upper half stays free
+        }
+
+        blocks[start] = {order, size};
+        record_allocation(size, 1u << order);
+        return static_cast<int>(start);
+    }
+
+    bool release(int number) override {
+        auto block = blocks.find(static_cast<unsigned int>(number));
+        if(number < 0 || block == blocks.end()) {
+            return false;
+        }
+
+        unsigned int start = block->first;
+        int order = block->second.order;
+        record_release(block->second.requested, 1u << order);
+        blocks.erase(block);
+
+        while(order + 1 < static_cast<int>(free_lists.size())) {
+            auto buddy = free_lists[order].find(start ^ (1u << order));
+            if(buddy == free_lists[order].end()) {
+                break;
+            }
+            free_lists[order].erase(buddy);
+            start &= ~(1u << order);
+            order++;
+        }
+        free_blocks(order).insert(start);
+        return true;
+    }
+
+protected:
+    void save_blocks(std::ostream &out) const override {
+        write_value<uint64_t>(out, free_lists.size());
+        for(const auto &free_list : free_lists) {
+            write_vector(out, std::vector<unsigned int>(free_list.begin(), free_list.end()));
+        }
+        std::vector<saved_block> allocated;
+        for(const auto &block : blocks) {
+            allocated.push_back({block.first, block.second});
+        }
+        write_vector(out, allocated);
+    }
+
+    bool load_blocks(std::istream &in) override {
+        uint64_t orders = 0;
+        if(!read_value(in, orders) || orders > 32) {
+            return false;
+        }
+        free_lists.assign(orders, {});
+        for(auto &free_list : free_lists) {
+            std::vector<unsigned int> starts;
+            if(!read_vector(in, starts)) {
+                return false;
+            }
+            free_list.insert(starts.begin(), starts.end());
+        }
+        std::vector<saved_block> allocated;
+        if(!read_vector(in, allocated)) {
+            return false;
+        }
+        blocks.clear();
+        for(const auto &block : allocated) {
+            blocks[block.start] = block.block;
+        }
+        return true;
+    }
+
+private:
+    struct block_info {
+        int             order;
+        unsigned int    requested;
+    };
+
+    struct saved_block {
+        unsigned int    start;
+        block_info      block;
+    };
+
+    std::set<unsigned int> &free_blocks(int order) {
+        if(static_cast<int>(free_lists.size()) <= order) {
+            free_lists.resize(order + 1);
+        }
+        return free_lists[order];
+    }
+
+    std::vector<std::set<unsigned int>>             free_lists;     // start addresses per order
+    std::unordered_map<unsigned int, block_info>    blocks;         // start -> allocated block
+};
+
+//Builds the allocation engine for one run. Variable partitions and the buddy system
+//manage memory_size MB, or as much memory as the partition table adds up to if it is 0.
+inline std::unique_ptr<memory_manager> make_memory_manager(memory_mode mode,
+                                                           const std::vector<memory_partition> &partitions,
+                                                           unsigned int memory_size) {
+    if(memory_size == 0) {
+        for(const auto &partition : partitions) {
+            memory_size += partition.size;
+        }
+    }
+
+    switch(mode) {
+        case FIXED_PARTITIONS:  return std::make_unique<fixed_partition_memory>(partitions);
+        case BUDDY:             return std::make_unique<buddy_memory>(memory_size);
+        default:                return std::make_unique<variable_partition_memory>(memory_size, mode);
+    }
+}
+
+#endif
@@ -0,0 +1,286 @@
+/**
+ * @file regress.cpp
+ * Golden-output regression harness for SYSC4001 A3 P1: runs every scheduling
+ * policy over a corpus of workloads with a simulator binary (./bin/main --trace)
+ * and compares the transition streams with stored golden traces, or with the
+ * streams of another simulator binary, reporting the first divergence of each
+ */
+
+#include "interrupts_student1_student2.hpp"
+#include <chrono>
+#include <filesystem>
+#include <map>
+
+namespace fs = std::filesystem;
+
+static void usage() {
+    std::cout << "To run the program, do: ./bin/regress <mode> <corpus_file> ...\n"
+              << "  record  <corpus_file> <golden_dir> [--main <simulator>]    store the golden traces\n"
+              << "  check   <corpus_file> <golden_dir> [--main <simulator>]    compare against them\n"
+              << "  compare <corpus_file> <old_simulator> <new_simulator>      run two builds side by side\n"
+              << "  --generator <program>    builds the generated workloads (default ./bin/generate_workload)\n"
+              << "  --policies <a,b,...>     policies to run (default all)\n"
+              << "  --main defaults to ./bin/main; see golden_files/corpus.txt for the corpus format" << std::endl;
+}
+
+// ------------------ corpus ------------------
+// One directive per line, # starts a comment:
+//   generate <name> <generate_workload options...>   a workload made by the generator
+//   run <input> [simulator options...]               a case; every policy is run on it
+// <input> is a generated workload's name or an input file (relative to the current directory).
+
+struct regress_case {
+    std::string                 name;       // names its golden traces: <name>_<policy>.bin
+    std::string                 input;
+    std::vector<std::string>    options;
+};
+
+struct corpus {
+    std::vector<std::pair<std::string, std::vector<std::string>>>  generated;  // name, generator options
+    std::vector<regress_case>                                       cases;
+};
+
+static bool load_corpus(const std::string &path, corpus &result) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        std::vector<std::string> tokens = split_whitespace(line.substr(0, line.find('#')));
+        if (tokens.empty()) {
+            continue;
+        }
+        if (tokens[0] == "generate" && tokens.size() >= 2) {
+            result.generated.push_back({tokens[1], {tokens.begin() + 2, tokens.end()}});
+        } else if (tokens[0] == "run" && tokens.size() >= 2) {
+            char number[8];
+            std::snprintf(number, sizeof(number), "%02zu", result.cases.size() + 1);
+            std::string name = std::string(number) + "_" + fs::path(tokens[1]).stem().string();
+            result.cases.push_back({name, tokens[1], {tokens.begin() + 2, tokens.end()}});
+        } else {
+            std::cerr << "Error: " << path << ":" << line_number
+                      << ": expected \"generate <name> <options...>\" or \"run <input> [options...]\"" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ------------------ running a simulator ------------------
+
+static std::string quoted(const std::string &text) {
+    std::string result = "'";
+    for (char c : text) {
+        result += c == '\'' ? std::string("'\\''") : std::string(1, c);
+    }
+    return result + "'";
+}
+
+// Runs a command in dir with its output going to dir/run.log; true if it exited with 0
+static bool run_command(const fs::path &dir, const std::string &command) {
+    std::string line = "cd " + quoted(dir.string()) + " && " + command + " > run.log 2>&1";
+    if (std::system(line.c_str()) != 0) {
+        std::cerr << "Error: command failed (see " << (dir / "run.log").string() << "): " << command << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Runs one policy on one case in its own directory, since the simulator always
+// writes to output_files/, and leaves the path of the trace it wrote in trace
+static bool run_case(const fs::path &simulator, const fs::path &dir, const fs::path &input,
+                     const std::string &policy, const std::vector<std::string> &options,
+                     fs::path &trace, double &seconds) {
+    fs::create_directories(dir / "output_files");
+    std::string command = quoted(simulator.string()) + " " + quoted(input.string()) + " " + policy + " --trace";
+    for (const std::string &option : options) {
+        command += " " + quoted(option);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = run_command(dir, command);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    trace = dir / "output_files" / (policy + "_execution.bin");
+    return ok;
+}
+
+// ------------------ traces ------------------
+
+static bool read_trace(const fs::path &path, std::vector<trace_record> &records) {
+    std::ifstream file(path, std::ios::binary);
+    trace_header header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        header.version != TRACE_VERSION || header.record_size != sizeof(trace_record)) {
+        std::cerr << "Error: " << path.string() << " is missing or not an execution trace" << std::endl;
+        return false;
+    }
+
+    records.clear();
+    trace_record record;
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+    return true;
+}
+
+static bool same_record(const trace_record &first, const trace_record &second) {
+    return first.time == second.time && first.PID == second.PID && first.old_state == second.old_state &&
+           first.new_state == second.new_state && first.cpu == second.cpu;
+}
+
+static std::string describe(const std::vector<trace_record> &records, size_t index) {
+    if (index >= records.size()) {
+        return "(end of trace)";
+    }
+    const trace_record &record = records[index];
+    std::string text = "t=" + std::to_string(record.time) + " PID " + std::to_string(record.PID) + " "
+                     + state_name(static_cast<states>(std::min<int>(record.old_state, NOT_ASSIGNED))) + " -> "
+                     + state_name(static_cast<states>(std::min<int>(record.new_state, NOT_ASSIGNED)));
+    if (record.cpu != 0) {
+        text += " on CPU " + std::to_string(record.cpu - 1);
+    }
+    return text;
+}
+
+// Compares two transition streams. On a difference, prints the first divergence with
+// a few transitions of context on either side and returns false.
+static bool compare_traces(const std::string &label, const std::vector<trace_record> &expected,
+                           const std::vector<trace_record> &actual, const char *expected_name,
+                           const char *actual_name) {
+    size_t common = std::min(expected.size(), actual.size());
+    size_t first = 0;
+    while (first < common && same_record(expected[first], actual[first])) {
+        first++;
+    }
+    if (first == common && expected.size() == actual.size()) {
+        return true;
+    }
+
+    std::cout << "DIFF " << label << ": first divergence at transition " << first << " ("
+              << expected.size() << " " << expected_name << ", " << actual.size() << " " << actual_name
+              << " transitions)" << std::endl;
+    const size_t context = 3;
+    for (size_t i = first > context ? first - context : 0; i < first + context + 1; i++) {
+        if (i >= expected.size() && i >= actual.size()) {
+            break;
+        }
+        std::string left = describe(expected, i);
+        std::string right = describe(actual, i);
+        std::cout << (i == first ? "  > " : "    ") << std::setw(8) << i << "  " << std::left << std::setw(44)
+                  << left << std::right << (i < first ? "  (same)" : "  | " + right) << std::endl;
+    }
+    return false;
+}
+
+// ------------------ modes ------------------
+
+int main(int argc, char **argv) {
+
+    if (argc < 4) {
+        usage();
+        return -1;
+    }
+    std::string mode = argv[1];
+    if (mode != "record" && mode != "check" && mode != "compare") {
+        usage();
+        return -1;
+    }
+
+    fs::path simulator = "bin/main";
+    fs::path generator = "bin/generate_workload";
+    std::vector<std::string> policies = scheduler_names;
+    std::vector<std::string> positional;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--main" && i + 1 < argc)               simulator = argv[++i];
+        else if (arg == "--generator" && i + 1 < argc)     generator = argv[++i];
+        else if (arg == "--policies" && i + 1 < argc)      policies = split_delim(argv[++i], ",");
+        else                                               positional.push_back(arg);
+    }
+    if (positional.size() != (mode == "compare" ? 3u : 2u)) {
+        usage();
+        return -1;
+    }
+
+    corpus cases;
+    if (!load_corpus(positional[0], cases)) {
+        return -1;
+    }
+
+    // the engines under test; compare runs an old and a new build, the others one build
+    std::vector<fs::path> engines = {fs::absolute(simulator)};
+    fs::path golden_dir = positional[1];
+    if (mode == "compare") {
+        engines = {fs::absolute(positional[1]), fs::absolute(positional[2])};
+    }
+    if (mode == "record") {
+        fs::create_directories(golden_dir);
+    }
+
+    fs::path work = fs::temp_directory_path() /
+                    ("sim_regress_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(work);
+
+    // generated workloads are made fresh every time; the generator is deterministic
+    std::map<std::string, fs::path> inputs;
+    for (const auto &workload : cases.generated) {
+        fs::path path = work / workload.first;
+        std::string command = quoted(fs::absolute(generator).string()) + " --output " + quoted(path.string());
+        for (const std::string &option : workload.second) {
+            command += " " + quoted(option);
+        }
+        if (!run_command(work, command)) {
+            return -1;
+        }
+        inputs[workload.first] = path;
+    }
+
+    int failures = 0, runs = 0;
+    for (const regress_case &test : cases.cases) {
+        fs::path input = inputs.count(test.input) ? inputs[test.input] : fs::absolute(test.input);
+        for (const std::string &policy : policies) {
+            std::string label = test.name + " " + policy;
+            std::vector<std::vector<trace_record>> traces(engines.size());
+            std::vector<double> seconds(engines.size());
+            bool ok = true;
+            for (size_t e = 0; ok && e < engines.size(); e++) {
+                fs::path trace;
+                ok = run_case(engines[e], work / ("engine" + std::to_string(e)), input, policy, test.options,
+                              trace, seconds[e]) && read_trace(trace, traces[e]);
+                if (ok && mode == "record") {
+                    fs::copy_file(trace, golden_dir / (test.name + "_" + policy + ".bin"),
+                                  fs::copy_options::overwrite_existing);
+                }
+            }
+            runs++;
+
+            if (ok && mode == "check") {
+                std::vector<trace_record> golden;
+                ok = read_trace(golden_dir / (test.name + "_" + policy + ".bin"), golden) &&
+                     compare_traces(label, golden, traces[0], "golden", "new");
+            } else if (ok && mode == "compare") {
+                ok = compare_traces(label, traces[0], traces[1], "old", "new");
+                std::cout << (ok ? "same " : "     ") << label << ": " << traces[1].size() << " transitions, old "
+                          << seconds[0] << " s, new " << seconds[1] << " s" << std::endl;
+            } else if (ok) {
+                std::cout << "recorded " << label << ": " << traces[0].size() << " transitions" << std::endl;
+            }
+            failures += !ok;
+        }
+    }
+
+    if (failures == 0) {
+        fs::remove_all(work);
+    } else {
+        std::cout << "Traces and logs of this run are kept in " << work.string() << std::endl;
+    }
+    std::cout << runs - failures << " of " << runs << " runs " << (mode == "record" ? "recorded" : "match")
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file trace_to_text.cpp
+ * Renders a binary execution trace (./bin/main ... --trace) back into the
+ * usual execution table for SYSC4001 A3 P1
+ */
+
+#include "interrupts_student1_student2.hpp"
+
+int main(int argc, char **argv) {
+
+    if (argc != 3) {
+        std::cout << "ERROR!\nExpected 2 arguments, received " << argc - 1 << std::endl;
+        std::cout << "To run the program, do: ./bin/trace_to_text <trace_file> <output_file.txt>" << std::endl;
+        return -1;
+    }
+
+    std::ifstream trace(argv[1], std::ios::binary);
+    if (!trace.is_open()) {
+        std::cerr << "Error: Unable to open file: " << argv[1] << std::endl;
+        return -1;
+    }
+
+    // check the header before trusting the records
+    trace_header header;
+    if (!trace.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        std::cerr << "Error: " << argv[1] << " is not an execution trace" << std::endl;
+        return -1;
+    }
+    if (header.version != TRACE_VERSION || header.record_size != sizeof(trace_record)) {
+        std::cerr << "Error: unsupported trace version " << header.version
+                  << " (record size " << header.record_size << ")" << std::endl;
+        return -1;
+    }
+
+    execution_log log(LOG_TO_FILE, argv[2]);
+    if (!log.good()) {
+        return -1;
+    }
+
+    // convert the records a chunk at a time; multi-CPU traces store CPU + 1 in
+    // every record, so the first one says whether the table needs a CPU column
+    std::vector<trace_record> records(execution_log::chunk_size / sizeof(trace_record));
+    unsigned long long converted = 0;
+    bool started = false;
+    while (trace) {
+        trace.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(trace_record));
+        size_t bytes = static_cast<size_t>(trace.gcount());
+        if (bytes % sizeof(trace_record) != 0) {
+            std::cerr << "Error: " << argv[1] << " ends with a partial record" << std::endl;
+            return -1;
+        }
+        if (!started) {
+            log.header(bytes > 0 && records[0].cpu != 0);
+            started = true;
+        }
+
+        for (size_t i = 0; i < bytes / sizeof(trace_record); i++) {
+            const trace_record &record = records[i];
+            if (record.old_state >= NUM_STATES || record.new_state >= NUM_STATES) {
+                std::cerr << "Error: record " << converted + i << " has an invalid state" << std::endl;
+                return -1;
+            }
+            log.status(record.time, record.PID,
+                       static_cast<states>(record.old_state), static_cast<states>(record.new_state),
+                       record.cpu - 1);
+        }
+        converted += bytes / sizeof(trace_record);
+    }
+
+    log.footer();
+    std::cout << "Converted " << converted << " transitions into " << argv[2] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file workload_generator.hpp
+ * @brief seeded synthetic workloads for SYSC4001 A3 P1, shared by the
+ * generate_workload tool and the benchmark
+ *
+ */
+
+#ifndef WORKLOAD_GENERATOR_HPP_
+#define WORKLOAD_GENERATOR_HPP_
+
+#include "interrupts_student1_student2.hpp"
+#include<cmath>
+#include<random>
+
+// ------------------ random numbers ------------------
+// std::mt19937_64 produces the same sequence everywhere, but the standard
+// distributions don't, so the samples are computed here from the raw engine
+// output to keep a seed reproducible across compilers.
+
+// uniform double in [0, 1)
+inline double uniform01(std::mt19937_64 &rng) {
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// uniform integer in [low, high]
+inline long long uniform_int(std::mt19937_64 &rng, long long low, long long high) {
+    return low + static_cast<long long>(uniform01(rng) * static_cast<double>(high - low + 1));
+}
+
+// exponential with the given mean
+inline double exponential(std::mt19937_64 &rng, double mean) {
+    return -mean * std::log(1.0 - uniform01(rng));
+}
+
+// ------------------ distribution specs ------------------
+// "none", "fixed:<v>", "uniform:<low>:<high>" or "exp:<mean>"
+struct distribution {
+    std::string kind = "none";
+    double a = 0;
+    double b = 0;
+
+    long long sample(std::mt19937_64 &rng) const {
+        if(kind == "fixed")   return std::llround(a);
+        if(kind == "uniform") return uniform_int(rng, std::llround(a), std::llround(b));
+        if(kind == "exp")     return std::llround(exponential(rng, a));
+        return 0;
+    }
+};
+
+inline bool parse_distribution(const std::string &spec, distribution &dist) {
+    std::vector<std::string> parts = split_delim(spec, ":");
+    if(parts.empty()) return false;
+
+    try {
+        dist.kind = parts[0];
+        if(dist.kind == "none" && parts.size() == 1) return true;
+        if((dist.kind == "fixed" || dist.kind == "exp") && parts.size() == 2) {
+            dist.a = std::stod(parts[1]);
+            return dist.a >= 0;
+        }
+        if(dist.kind == "uniform" && parts.size() == 3) {
+            dist.a = std::stod(parts[1]);
+            dist.b = std::stod(parts[2]);
+            return 0 <= dist.a && dist.a <= dist.b;
+        }
+    } catch(const std::exception &) {
+    }
+    return false;
+}
+
+// ------------------ arrival processes ------------------
+// "poisson:<mean gap>"                 exponential gaps between single arrivals
+// "bursty:<mean gap>:<mean burst>"     bursts of ~mean burst arrivals at the same
+//                                      time, with exponential gaps between bursts
+// "fixed:<gap>"                        one arrival every gap ms
+struct arrival_process {
+    std::string kind = "poisson";
+    double gap = 10;
+    double burst = 1;
+    long long left_in_burst = 0;
+
+    unsigned long long next_gap(std::mt19937_64 &rng) {
+        if(kind == "fixed") return std::llround(gap);
+        if(kind == "bursty") {
+            if(left_in_burst > 0) {
+                left_in_burst--;
+                return 0;
+            }
+            left_in_burst = std::llround(exponential(rng, burst - 1));
+        }
+        return std::llround(exponential(rng, gap));
+    }
+};
+
+inline bool parse_arrivals(const std::string &spec, arrival_process &arrivals) {
+    std::vector<std::string> parts = split_delim(spec, ":");
+    if(parts.size() < 2) return false;
+
+    try {
+        arrivals.kind = parts[0];
+        arrivals.gap = std::stod(parts[1]);
+        if(arrivals.kind == "bursty" && parts.size() == 3) {
+            arrivals.burst = std::stod(parts[2]);
+            return arrivals.gap >= 0 && arrivals.burst >= 1;
+        }
+        return (arrivals.kind == "poisson" || arrivals.kind == "fixed") && parts.size() == 2 && arrivals.gap >= 0;
+    } catch(const std::exception &) {
+        return false;
+    }
+}
+
+// ------------------ workloads ------------------
+
+// Everything that shapes a generated workload
+struct workload_spec {
+    long long                       processes = 1000;
+    unsigned long long              seed = 1;
+    arrival_process                 arrivals;
+    distribution                    cpu{"exp", 100};            // total CPU time per process
+    distribution                    io_freq;                    // CPU ms between I/Os, 0 = none
+    distribution                    io_duration{"uniform", 1, 10};
+    distribution                    size;                       // "none" = fits a random partition
+    std::vector<memory_partition>   partitions = default_memory_partitions;
+};
+
+// Produces the processes of a spec one at a time, in PID and arrival order
+class workload_generator {
+public:
+    explicit workload_generator(const workload_spec &spec)
+        : spec(spec), arrivals(spec.arrivals), rng(spec.seed) {}
+
+    bool done() const { return next_pid > spec.processes; }
+
+    PCB next() {
+        arrival_time += arrivals.next_gap(rng);
+
+        PCB process;
+        process.PID = static_cast<int>(next_pid++);
+        // by default every process fits in some partition of the table
+        if(spec.size.kind == "none") {
+            const memory_partition &partition = spec.partitions[uniform_int(rng, 0, spec.partitions.size() - 1)];
+            process.size = static_cast<unsigned int>(uniform_int(rng, 1, partition.size));
+        } else {
+            process.size = static_cast<unsigned int>(std::max(1LL, spec.size.sample(rng)));
+        }
+        process.arrival_time = static_cast<unsigned int>(arrival_time);
+        process.processing_time = static_cast<unsigned int>(std::max(1LL, spec.cpu.sample(rng)));
+        process.remaining_time = process.processing_time;
+        long long frequency = spec.io_freq.sample(rng);
+        process.io_freq = static_cast<unsigned int>(frequency);
+        process.io_duration = static_cast<unsigned int>(frequency > 0 ? spec.io_duration.sample(rng) : 0);
+        process.start_time = -1;
+        process.partition_number = -1;
+        process.state = NOT_ASSIGNED;
+        return process;
+    }
+
+private:
+    const workload_spec &spec;
+    arrival_process     arrivals;
+    std::mt19937_64     rng;
+    long long           next_pid = 1;
+    unsigned long long  arrival_time = 0;
+};
+
+// Generates a whole workload in memory
+inline std::vector<PCB> generate_workload(const workload_spec &spec) {
+    std::vector<PCB> processes;
+    processes.reserve(spec.processes);
+    for(workload_generator generator(spec); !generator.done();) {
+        processes.push_back(generator.next());
+    }
+    return processes;
+}
+
+#endif
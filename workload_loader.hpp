@@ -0,0 +1,169 @@
+/**
+ * @file workload_loader.hpp
+ * @brief fast loader for SYSC4001 A3 P1 input files
+ *
+ */
+
+#ifndef WORKLOAD_LOADER_HPP_
+#define WORKLOAD_LOADER_HPP_
+
+#include "interrupts_student1_student2.hpp"
+
+#ifdef _WIN32
+#include<fstream>
+#include<iterator>
+#else
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<unistd.h>
+#endif
+
+//Read-only view of a whole file: memory-mapped on POSIX systems, read into one
+//buffer elsewhere. The view stays valid as long as the object lives.
+class mapped_file {
+public:
+    explicit mapped_file(const std::string &path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open()) {
+            return;
+        }
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        view = contents.data();
+        length = contents.size();
+        opened = true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            return;
+        }
+        struct stat info;
+        if(::fstat(fd, &info) == 0) {
+            opened = true;
+            length = static_cast<size_t>(info.st_size);
+            if(length > 0) {
+                void *mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapping == MAP_FAILED) {
+                    opened = false;
+                    length = 0;
+                } else {
+                    view = static_cast<const char *>(mapping);
+                    ::madvise(mapping, length, MADV_SEQUENTIAL);
+                }
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~mapped_file() {
+#ifndef _WIN32
+        if(length > 0 && view != nullptr) {
+            ::munmap(const_cast<char *>(view), length);
+        }
+#endif
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    bool is_open() const { return opened; }
+    const char *data() const { return view; }
+    size_t size() const { return length; }
+
+private:
+    const char  *view = nullptr;
+    size_t      length = 0;
+    bool        opened = false;
+#ifdef _WIN32
+    std::string contents;
+#endif
+};
+
+//Parses one number of a workload line and the separator after it (blanks and at
+//most one comma). Returns false if there is no number at p.
+template<typename T>
+bool parse_field(const char *&p, const char *end, T &value) {
+    auto [next, error] = std::from_chars(p, end, value);
+    if(error != std::errc() || next == p) {
+        return false;
+    }
+
+    p = next;
+    while(p < end && (*p == ' ' || *p == '\t')) p++;
+    if(p < end && *p == ',') p++;
+    while(p < end && (*p == ' ' || *p == '\t')) p++;
+    return true;
+}
+
+//Loads a workload file into list_processes. Every line holds the six numbers
+//"PID size arrival_time processing_time io_freq io_duration", separated by commas
+//and/or blanks (both "1, 20, 0, 300, 5, 3" and "201  60  0   90  50  4" work).
+//Blank lines and lines starting with '#' are skipped. The file is parsed in place,
+//without copying lines or tokens. Malformed lines are reported with their line
+//number (the first max_errors of them); returns false if there were any.
+inline bool load_workload(const std::string &path, std::vector<PCB> &list_processes,
+                          int max_errors = 10) {
+    mapped_file file(path);
+    if(!file.is_open()) {
+        std::cerr << "Error: could not open input file: " << path << std::endl;
+        return false;
+    }
+
+    const char *p = file.data();
+    const char *end = p + file.size();
+    list_processes.reserve(list_processes.size() + std::count(p, end, '\n') + 1);
+
+    int errors = 0;
+    unsigned long long line_number = 0;
+    while(p < end) {
+        line_number++;
+        const char *line_end = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if(line_end == nullptr) {
+            line_end = end;
+        }
+
+        const char *field = p;
+        p = line_end + 1;
+
+        while(field < line_end && (*field == ' ' || *field == '\t' || *field == '\r')) field++;
+        if(field == line_end || *field == '#') {
+            continue;
+        }
+
+        PCB process;
+        bool valid = parse_field(field, line_end, process.PID)
+                  && parse_field(field, line_end, process.size)
+                  && parse_field(field, line_end, process.arrival_time)
+                  && parse_field(field, line_end, process.processing_time)
+                  && parse_field(field, line_end, process.io_freq)
+                  && parse_field(field, line_end, process.io_duration);
+        while(field < line_end && *field == '\r') field++;
+
+        if(!valid || field != line_end) {
+            if(errors++ < max_errors) {
+                std::cerr << "Error: " << path << ":" << line_number
+                          << ": expected \"PID size arrival_time processing_time io_freq io_duration\"" << std::endl;
+            }
+            continue;
+        }
+
+        process.remaining_time = process.processing_time;
+        process.start_time = -1;
+        process.partition_number = -1;
+        process.state = NOT_ASSIGNED;
+        list_processes.push_back(std::move(process));
+    }
+
+    if(errors > max_errors) {
+        std::cerr << "Error: " << path << ": " << errors - max_errors << " more malformed lines" << std::endl;
+    }
+    if(errors == 0 && list_processes.empty()) {
+        std::cerr << "No valid processes were loaded from " << path << std::endl;
+        return false;
+    }
+    return errors == 0;
+}
+
+#endif